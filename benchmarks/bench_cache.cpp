@@ -0,0 +1,164 @@
+#include "../concurrent_clock_cache.h"
+#include "../concurrent_lru_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Read-through cache workload: keys drawn from a Zipf(0.99) distribution
+// over 1M keys, a cache holding 5% of them, and a put on every miss. The
+// usual hand-written cache (std::unordered_map and std::list behind one
+// mutex, since every hit reorders the list) against lru_cache and
+// clock_cache. Reports throughput and hit ratio.
+
+const long key_space = 1000000;
+const size_t capacity = 50000;
+const int ops_per_thread = 1000000;
+
+class mutex_lru {
+  std::mutex _mutex;
+  std::list<long> _order;
+  std::unordered_map<long, std::pair<long, std::list<long>::iterator>>
+      _entries;
+
+public:
+  explicit mutex_lru(size_t) {}
+
+  bool get(long key, long &value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+      return false;
+    _order.splice(_order.begin(), _order, it->second.second);
+    value = it->second.first;
+    return true;
+  }
+
+  void put(long key, long value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_entries.count(key))
+      return;
+    _order.push_front(key);
+    _entries[key] = {value, _order.begin()};
+    if (_entries.size() > capacity) {
+      _entries.erase(_order.back());
+      _order.pop_back();
+    }
+  }
+};
+
+struct lru {
+  concurrent::lru_cache<long, long> cache;
+
+  explicit lru(size_t n) : cache(n) {}
+  bool get(long key, long &value) {
+    auto found = cache.get(key);
+    if (found)
+      value = *found;
+    return found.has_value();
+  }
+  void put(long key, long value) { cache.put(key, value); }
+};
+
+struct clock_sweep {
+  concurrent::clock_cache<long, long> cache;
+
+  explicit clock_sweep(size_t n) : cache(n) {}
+  bool get(long key, long &value) {
+    auto found = cache.get(key);
+    if (found)
+      value = *found;
+    return found.has_value();
+  }
+  void put(long key, long value) { cache.put(key, value); }
+};
+
+// Keys in Zipf order, drawn up front so that sampling is not timed
+std::vector<long> zipf_keys(size_t count, unsigned seed) {
+  static const std::vector<double> cdf = [] {
+    std::vector<double> c(key_space);
+    double sum = 0;
+    for (long i = 0; i < key_space; ++i)
+      c[i] = sum += 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+    for (double &x : c)
+      x /= sum;
+    return c;
+  }();
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<long> keys(count);
+  for (auto &key : keys)
+    key = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+  return keys;
+}
+
+struct result {
+  double mops;
+  double hit_ratio;
+};
+
+template <typename Cache> result run(int num_threads) {
+  Cache cache(capacity);
+  std::vector<std::vector<long>> keys;
+  for (int t = 0; t < num_threads; ++t)
+    keys.push_back(zipf_keys(ops_per_thread, static_cast<unsigned>(t)));
+
+  std::vector<long> hits(num_threads);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      long local_hits = 0, value;
+      for (long key : keys[t]) {
+        if (cache.get(key, value))
+          ++local_hits;
+        else
+          cache.put(key, key);
+      }
+      hits[t] = local_hits;
+    });
+  for (auto &th : threads)
+    th.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  long total_hits = 0;
+  for (long h : hits)
+    total_hits += h;
+  double ops = static_cast<double>(num_threads) * ops_per_thread;
+  return {ops / seconds / 1e6, total_hits / ops};
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) * 2 && t <= 64; t *= 2)
+    thread_counts.push_back(t);
+
+  std::cout << "Read-through cache (Mops/s, hit ratio)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(22) << "mutex+list LRU"
+            << std::setw(22) << "lru_cache" << std::setw(22) << "clock_cache"
+            << std::endl;
+
+  for (int t : thread_counts) {
+    result locked = run<mutex_lru>(t);
+    result sharded = run<lru>(t);
+    result clocked = run<clock_sweep>(t);
+    std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+              << std::setw(14) << locked.mops << std::setw(8)
+              << locked.hit_ratio << std::setw(14) << sharded.mops
+              << std::setw(8) << sharded.hit_ratio << std::setw(14)
+              << clocked.mops << std::setw(8) << clocked.hit_ratio
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "../concurrent_counter_map.h"
+#include "../concurrent_unordered_map.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Increment throughput on a single hot key: unordered_map through
+// execute_exclusive, counter_map with one atomic, counter_map with the key
+// striped over per-thread cells, and the lock-free handle to those cells.
+
+const int increments_per_thread = 200000;
+
+template <typename Increment> double mops(int num_threads, Increment increment) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&]() {
+      for (int i = 0; i < increments_per_thread; ++i)
+        increment();
+    });
+  for (auto &th : threads)
+    th.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return static_cast<double>(num_threads) * increments_per_thread / seconds /
+         1e6;
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) * 2 && t <= 64; t *= 2)
+    thread_counts.push_back(t);
+
+  std::cout << "Hot key increments (Mops/s)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "exclusive"
+            << std::setw(14) << "atomic" << std::setw(14) << "striped"
+            << std::setw(14) << "handle" << std::endl;
+
+  for (int t : thread_counts) {
+    concurrent::unordered_map<int, long> map;
+    map.insert(0, 0);
+    concurrent::counter_map<int> atomic;
+    atomic.increment(0);
+    concurrent::counter_map<int> striped;
+    concurrent::hot_counter<long> handle = striped.stripe(0);
+
+    std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+              << std::setw(14)
+              << mops(t, [&] {
+                   map.execute_exclusive([](auto &m) { ++m[0]; });
+                 })
+              << std::setw(14) << mops(t, [&] { atomic.increment(0); })
+              << std::setw(14) << mops(t, [&] { striped.increment(0); })
+              << std::setw(14) << mops(t, [&] { handle.increment(); })
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include "../internal/epoch.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Measures the cost of retiring a node through epoch_domain, including the
+// amortized cost of advancing the epoch and freeing limbo lists, against
+// deleting the node immediately.
+
+struct node {
+  std::uint64_t payload[4];
+};
+
+// Keeps the compiler from eliding the new/delete pair of the baseline
+std::atomic<node *> sink{nullptr};
+
+template <typename Body>
+double run_threads(int num_threads, int ops_per_thread, Body body) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&]() {
+      for (int i = 0; i < ops_per_thread; ++i)
+        body();
+    });
+  for (auto &t : threads)
+    t.join();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         (static_cast<double>(num_threads) * ops_per_thread);
+}
+
+int main() {
+  const int ops_per_thread = 200000;
+  const int thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+  std::cout << std::setw(8) << "threads" << std::setw(18) << "delete ns/node"
+            << std::setw(18) << "retire ns/node" << std::endl;
+
+  for (int num_threads : thread_counts) {
+    double baseline = run_threads(num_threads, ops_per_thread, []() {
+      node *n = new node();
+      sink.store(n, std::memory_order_relaxed);
+      delete n;
+    });
+
+    double retired;
+    {
+      concurrent::internal::epoch_domain domain;
+      retired = run_threads(num_threads, ops_per_thread, [&]() {
+        node *n = new node();
+        {
+          auto guard = domain.pin();
+        }
+        domain.retire(n);
+      });
+    }
+
+    std::cout << std::setw(8) << num_threads << std::setw(18) << std::fixed
+              << std::setprecision(1) << baseline << std::setw(18) << retired
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include "../concurrent_hash.h"
+#include "../concurrent_unordered_map.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Integer-ID and URL-path lookups through concurrent::flat_unordered_map
+// against the node-based concurrent::unordered_map with the same hash.
+
+template <typename Map, typename Key>
+double lookup_ns(const Map &map, const std::vector<Key> &probes, int rounds) {
+  uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    for (const Key &k : probes)
+      sink += map.execute_shared([&k](const auto &m) {
+        auto it = m.find(k);
+        return it == m.end() ? 0 : it->second;
+      });
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // Keep the loop alive
+  if (sink == 42)
+    std::cout << "";
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         (static_cast<double>(probes.size()) * rounds);
+}
+
+template <typename Map, typename Key>
+double insert_ns(const std::vector<Key> &keys) {
+  auto start = std::chrono::steady_clock::now();
+  Map map;
+  for (size_t i = 0; i < keys.size(); ++i)
+    map.insert(keys[i], i);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         static_cast<double>(keys.size());
+}
+
+int main() {
+  using flat_map = concurrent::flat_unordered_map<uint64_t, uint64_t>;
+  using node_map = concurrent::unordered_map<uint64_t, uint64_t>;
+  using string_flat_map = concurrent::flat_unordered_map<std::string, uint64_t>;
+  using string_node_map = concurrent::unordered_map<std::string, uint64_t>;
+
+  std::cout << std::setw(10) << "keys" << std::setw(14) << "op"
+            << std::setw(12) << "node (ns)" << std::setw(12) << "flat (ns)"
+            << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+
+  std::mt19937_64 rng(1);
+  for (size_t n : {1000, 100000, 1000000}) {
+    std::vector<uint64_t> keys(n);
+    for (auto &k : keys)
+      k = rng();
+
+    flat_map flat;
+    node_map node;
+    for (uint64_t k : keys) {
+      flat.insert(k, k);
+      node.insert(k, k);
+    }
+
+    // Half hits, half misses, in random order
+    std::vector<uint64_t> probes;
+    for (size_t i = 0; i < 200000; ++i)
+      probes.push_back(i % 2 ? keys[rng() % n] : rng());
+    int rounds = 5;
+
+    std::cout << std::setw(10) << n << std::setw(14) << "find"
+              << std::setw(12) << lookup_ns(node, probes, rounds)
+              << std::setw(12) << lookup_ns(flat, probes, rounds) << std::endl;
+    std::cout << std::setw(10) << n << std::setw(14) << "insert"
+              << std::setw(12) << insert_ns<node_map>(keys) << std::setw(12)
+              << insert_ns<flat_map>(keys) << std::endl;
+  }
+
+  // Routing table: paths of 8 to 60 bytes sharing prefixes, so misses often
+  // match the first bytes of a stored key
+  for (size_t n : {1000, 100000}) {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < n; ++i)
+      paths.push_back("/api/v" + std::to_string(i % 3) + "/" +
+                      std::string(rng() % 50, 'r') + std::to_string(i));
+
+    string_flat_map flat;
+    string_node_map node;
+    for (size_t i = 0; i < n; ++i) {
+      flat.insert(paths[i], i);
+      node.insert(paths[i], i);
+    }
+
+    std::vector<std::string> probes;
+    for (size_t i = 0; i < 100000; ++i)
+      probes.push_back(i % 2 ? paths[rng() % n]
+                             : paths[rng() % n] + "/missing");
+    int rounds = 3;
+
+    std::cout << std::setw(10) << n << std::setw(14) << "path find"
+              << std::setw(12) << lookup_ns(node, probes, rounds)
+              << std::setw(12) << lookup_ns(flat, probes, rounds) << std::endl;
+    std::cout << std::setw(10) << n << std::setw(14) << "path insert"
+              << std::setw(12) << insert_ns<string_node_map>(paths)
+              << std::setw(12) << insert_ns<string_flat_map>(paths)
+              << std::endl;
+  }
+
+  return 0;
+}
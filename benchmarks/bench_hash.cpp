@@ -0,0 +1,90 @@
+#include "../concurrent_hash.h"
+#include "../concurrent_unordered_map.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Raw hashing speed of concurrent::hash against std::hash, and the effect of
+// the hash on a power-of-two table (the layout open addressing and sharding
+// use) for strided integer keys.
+
+template <typename Hash, typename Key>
+double hash_ns(const std::vector<Key> &keys, int rounds) {
+  Hash h;
+  size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    for (const auto &k : keys)
+      sink += h(k);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // Keep the loop alive
+  if (sink == 42)
+    std::cout << "";
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+         (static_cast<double>(keys.size()) * rounds);
+}
+
+// Longest run of occupied slots when keys are placed by the low bits of
+// their hash with linear probing
+template <typename Hash> size_t longest_probe(const std::vector<uint64_t> &keys) {
+  Hash h;
+  size_t capacity = 1;
+  while (capacity < keys.size() * 2)
+    capacity <<= 1;
+  std::vector<bool> used(capacity, false);
+  size_t longest = 0;
+  for (uint64_t k : keys) {
+    size_t i = h(k) & (capacity - 1), probe = 0;
+    while (used[i]) {
+      i = (i + 1) & (capacity - 1);
+      ++probe;
+    }
+    used[i] = true;
+    longest = std::max(longest, probe);
+  }
+  return longest;
+}
+
+int main() {
+  std::vector<uint64_t> ints(1 << 16);
+  for (size_t i = 0; i < ints.size(); ++i)
+    ints[i] = i * 4096;
+
+  std::cout << "ns per hash" << std::endl;
+  std::cout << std::setw(16) << "key" << std::setw(12) << "std::hash"
+            << std::setw(18) << "concurrent::hash" << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << std::setw(16) << "uint64_t" << std::setw(12)
+            << hash_ns<std::hash<uint64_t>>(ints, 200) << std::setw(18)
+            << hash_ns<concurrent::hash<uint64_t>>(ints, 200) << std::endl;
+
+  for (size_t len : {4, 8, 16, 32, 64, 256, 1024}) {
+    std::vector<std::string> strings;
+    for (int i = 0; i < 4096; ++i) {
+      std::string s(len, 'a');
+      for (size_t j = 0; j < len; ++j)
+        s[j] = static_cast<char>('a' + (i * 31 + j * 7) % 26);
+      strings.push_back(s);
+    }
+    int rounds = static_cast<int>(20000 / len) + 10;
+    std::cout << std::setw(16) << ("string[" + std::to_string(len) + "]")
+              << std::setw(12) << hash_ns<std::hash<std::string>>(strings, rounds)
+              << std::setw(18)
+              << hash_ns<concurrent::hash<std::string>>(strings, rounds)
+              << std::endl;
+  }
+
+  std::cout << "\nLongest linear probe, " << ints.size()
+            << " keys with stride 4096, power-of-two table" << std::endl;
+  std::cout << std::setw(16) << "std::hash" << std::setw(12)
+            << longest_probe<std::hash<uint64_t>>(ints) << std::endl;
+  std::cout << std::setw(16) << "concurrent::hash" << std::setw(12)
+            << longest_probe<concurrent::hash<uint64_t>>(ints) << std::endl;
+
+  return 0;
+}
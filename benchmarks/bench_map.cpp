@@ -0,0 +1,110 @@
+#include "../concurrent_map.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Ordered index workload (90% point lookups, 5% inserts, 5% erases, plus a
+// short range scan every 64 operations): concurrent::map against a std::map
+// behind a std::shared_mutex.
+
+const int ops_per_thread = 200000;
+const long key_space = 100000;
+
+class locked_map {
+  mutable std::shared_mutex _mutex;
+  std::map<long, long> _map;
+
+public:
+  void insert(long key, long value) {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _map.emplace(key, value);
+  }
+  void erase(long key) {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _map.erase(key);
+  }
+  bool contains(long key) const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _map.count(key) > 0;
+  }
+  long scan(long first, long last) const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    long sum = 0;
+    for (auto it = _map.lower_bound(first); it != _map.end() && it->first < last;
+         ++it)
+      sum += it->second;
+    return sum;
+  }
+};
+
+struct skip_map {
+  concurrent::map<long, long> map;
+
+  void insert(long key, long value) { map.insert(key, value); }
+  void erase(long key) { map.erase(key); }
+  bool contains(long key) const { return map.contains(key); }
+  long scan(long first, long last) const {
+    long sum = 0;
+    map.for_each_range(first, last, [&](long, long value) { sum += value; });
+    return sum;
+  }
+};
+
+template <typename Map> double mops(int num_threads) {
+  Map m;
+  for (long key = 0; key < key_space; key += 2)
+    m.insert(key, key);
+
+  std::vector<std::thread> threads;
+  std::vector<long> sinks(num_threads);
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      long sink = 0;
+      for (int i = 0; i < ops_per_thread; ++i) {
+        long key = static_cast<long>(rng() % key_space);
+        unsigned op = static_cast<unsigned>(rng() % 100);
+        if (i % 64 == 0)
+          sink += m.scan(key, key + 32);
+        else if (op < 5)
+          m.insert(key, key);
+        else if (op < 10)
+          m.erase(key);
+        else
+          sink += m.contains(key);
+      }
+      sinks[t] = sink;
+    });
+  for (auto &th : threads)
+    th.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return static_cast<double>(num_threads) * ops_per_thread / seconds / 1e6;
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) * 2 && t <= 64; t *= 2)
+    thread_counts.push_back(t);
+
+  std::cout << "Ordered index workload (Mops/s)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(20) << "shared_mutex+map"
+            << std::setw(16) << "concurrent::map" << std::endl;
+
+  for (int t : thread_counts)
+    std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+              << std::setw(20) << mops<locked_map>(t) << std::setw(16)
+              << mops<skip_map>(t) << std::endl;
+
+  return 0;
+}
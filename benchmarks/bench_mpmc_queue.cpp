@@ -0,0 +1,122 @@
+#include "../concurrent_mpmc_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Transfer throughput of mpmc_queue, one element and 16-element batches at a
+// time, against a std::deque behind a mutex, for 1..N producer/consumer
+// pairs.
+
+const long items_per_producer = 1000000;
+const size_t batch_size = 16;
+
+// The baseline every hand-rolled work queue starts from
+class locked_queue {
+  std::mutex _mutex;
+  std::deque<long> _items;
+
+public:
+  bool try_push(long value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _items.push_back(value);
+    return true;
+  }
+
+  std::optional<long> try_pop() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_items.empty())
+      return std::nullopt;
+    long value = _items.front();
+    _items.pop_front();
+    return value;
+  }
+};
+
+template <typename Push, typename Pop>
+double mops(int pairs, Push push, Pop pop) {
+  std::atomic<long> remaining(pairs * items_per_producer);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int p = 0; p < pairs; ++p)
+    threads.emplace_back([&]() {
+      for (long i = 0; i < items_per_producer;) {
+        long pushed = push(i);
+        if (pushed)
+          i += pushed;
+        else
+          std::this_thread::yield();
+      }
+    });
+  for (int c = 0; c < pairs; ++c)
+    threads.emplace_back([&]() {
+      while (remaining.load(std::memory_order_relaxed) > 0) {
+        long got = pop();
+        if (got)
+          remaining.fetch_sub(got, std::memory_order_relaxed);
+        else
+          std::this_thread::yield();
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return static_cast<double>(pairs) * items_per_producer / seconds / 1e6;
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> pair_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) && t <= 32; t *= 2)
+    pair_counts.push_back(t);
+  if (pair_counts.back() < 2)
+    pair_counts.push_back(2);
+
+  std::cout << "Transfer throughput (M items/s)" << std::endl;
+  std::cout << std::setw(8) << "pairs" << std::setw(14) << "mutex+deque"
+            << std::setw(14) << "mpmc" << std::setw(14) << "mpmc batch"
+            << std::endl;
+
+  for (int pairs : pair_counts) {
+    locked_queue locked;
+    concurrent::mpmc_queue<long> queue(4096);
+    concurrent::mpmc_queue<long> batched(4096);
+    std::cout << std::setw(8) << pairs << std::fixed << std::setprecision(2)
+              << std::setw(14)
+              << mops(
+                     pairs, [&](long i) { return locked.try_push(i) ? 1 : 0; },
+                     [&] { return locked.try_pop() ? 1L : 0L; })
+              << std::setw(14)
+              << mops(
+                     pairs, [&](long i) { return queue.try_push(i) ? 1 : 0; },
+                     [&] { return queue.try_pop() ? 1L : 0L; })
+              << std::setw(14)
+              << mops(
+                     pairs,
+                     [&](long i) {
+                       long items[batch_size];
+                       for (size_t k = 0; k < batch_size; ++k)
+                         items[k] = i + static_cast<long>(k);
+                       size_t n = std::min<long>(batch_size,
+                                                 items_per_producer - i);
+                       return static_cast<long>(batched.try_push_n(items, n));
+                     },
+                     [&] {
+                       long items[batch_size];
+                       return static_cast<long>(
+                           batched.try_pop_n(items, batch_size));
+                     })
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "../concurrent_mpsc_queue.h"
+#include "../concurrent_pool_allocator.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Many producers, one draining consumer (a log shipper or an actor mailbox):
+// mpsc_queue with std::allocator and with pool_allocator nodes, against a
+// std::deque behind a mutex that the consumer swaps out in one go.
+
+const long items_per_producer = 500000;
+
+class locked_queue {
+  std::mutex _mutex;
+  std::deque<long> _items;
+
+public:
+  void push(long value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _items.push_back(value);
+  }
+
+  template <typename F> size_t drain(F &&f) {
+    std::deque<long> batch;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      batch.swap(_items);
+    }
+    for (long value : batch)
+      f(value);
+    return batch.size();
+  }
+};
+
+template <typename Queue> double mops(int producers) {
+  Queue queue;
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&queue] {
+      for (long i = 0; i < items_per_producer; ++i)
+        queue.push(i);
+    });
+
+  long received = 0;
+  long sum = 0;
+  while (received < producers * items_per_producer) {
+    size_t got = queue.drain([&](long value) { sum += value; });
+    if (!got)
+      std::this_thread::yield();
+    received += static_cast<long>(got);
+  }
+  for (auto &t : threads)
+    t.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  if (sum < 0)
+    std::cout << sum; // Keep the consumer's work
+  return static_cast<double>(received) / seconds / 1e6;
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> producer_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) && t <= 32; t *= 2)
+    producer_counts.push_back(t);
+  if (producer_counts.back() < 2)
+    producer_counts.push_back(2);
+
+  std::cout << "Producers -> one consumer (M items/s)" << std::endl;
+  std::cout << std::setw(10) << "producers" << std::setw(14) << "mutex+deque"
+            << std::setw(14) << "mpsc" << std::setw(14) << "mpsc pool"
+            << std::endl;
+
+  for (int producers : producer_counts) {
+    std::cout << std::setw(10) << producers << std::fixed
+              << std::setprecision(2) << std::setw(14)
+              << mops<locked_queue>(producers) << std::setw(14)
+              << mops<concurrent::mpsc_queue<long>>(producers) << std::setw(14)
+              << mops<concurrent::mpsc_queue<long,
+                                             concurrent::pool_allocator<long>>>(
+                     producers)
+              << std::endl;
+  }
+
+  return 0;
+}
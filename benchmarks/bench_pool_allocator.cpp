@@ -0,0 +1,90 @@
+#include "../concurrent_pool_allocator.h"
+#include "../concurrent_unordered_map.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Insert throughput of concurrent::unordered_map with std::allocator against
+// concurrent::pool_allocator, for a map shared by all threads and for one map
+// per thread (where the global allocator is the only shared resource).
+
+using key_type = std::uint64_t;
+using value_type = std::uint64_t;
+
+using std_map = concurrent::unordered_map<key_type, value_type>;
+using pooled_map = concurrent::unordered_map<
+    key_type, value_type, std::hash<key_type>, std::equal_to<key_type>,
+    concurrent::pool_allocator<std::pair<const key_type, value_type>>>;
+
+const int items_per_thread = 200000;
+const int rounds = 3;
+
+template <typename Map> double shared_map_mops(int num_threads) {
+  double seconds = 0;
+  for (int r = 0; r < rounds; ++r) {
+    Map map;
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; ++t)
+      threads.emplace_back([&, t]() {
+        key_type base = static_cast<key_type>(t) * items_per_thread;
+        for (int i = 0; i < items_per_thread; ++i)
+          map.insert(base + i, i);
+      });
+    for (auto &th : threads)
+      th.join();
+    seconds += std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+  }
+  return static_cast<double>(num_threads) * items_per_thread * rounds /
+         seconds / 1e6;
+}
+
+template <typename Map> double private_map_mops(int num_threads) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([]() {
+      for (int r = 0; r < rounds; ++r) {
+        Map map;
+        for (int i = 0; i < items_per_thread; ++i)
+          map.insert(static_cast<key_type>(i), i);
+      }
+    });
+  for (auto &th : threads)
+    th.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return static_cast<double>(num_threads) * items_per_thread * rounds /
+         seconds / 1e6;
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) * 2 && t <= 64; t *= 2)
+    thread_counts.push_back(t);
+
+  std::cout << "Insert throughput (Mops/s)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "shared/std"
+            << std::setw(14) << "shared/pool" << std::setw(14)
+            << "private/std" << std::setw(14) << "private/pool" << std::endl;
+
+  for (int t : thread_counts) {
+    std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+              << std::setw(14) << shared_map_mops<std_map>(t) << std::setw(14)
+              << shared_map_mops<pooled_map>(t) << std::setw(14)
+              << private_map_mops<std_map>(t) << std::setw(14)
+              << private_map_mops<pooled_map>(t) << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "../concurrent_priority_queue.h"
+#include "../internal/container_base.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Scheduler workload: every thread alternates pushing a job with a random
+// priority and popping the most urgent one, on a queue prefilled with
+// 100000 jobs. A std::priority_queue wrapped in container_base with a
+// std::mutex, as our schedulers do today, against priority_queue in strict
+// mode (one element and batches of 16 per lock) and in relaxed mode.
+
+const int ops_per_thread = 400000;
+const long prefill = 100000;
+const size_t batch = 16;
+
+class locked_heap
+    : public concurrent::internal::container_base<std::priority_queue<long>,
+                                                  std::mutex> {
+public:
+  void push(long value) {
+    execute_exclusive([&](std::priority_queue<long> &q) { q.push(value); });
+  }
+  bool try_pop(long &out) {
+    return execute_exclusive([&](std::priority_queue<long> &q) {
+      if (q.empty())
+        return false;
+      out = q.top();
+      q.pop();
+      return true;
+    });
+  }
+};
+
+template <typename Queue, bool Batched = false, typename... Args>
+double mops(int num_threads, Args... args) {
+  Queue queue(args...);
+  for (long i = 0; i < prefill; ++i)
+    queue.push(i);
+
+  std::vector<std::thread> threads;
+  std::vector<long> sinks(num_threads);
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      long sink = 0;
+      std::vector<long> in, out;
+      for (int i = 0; i < ops_per_thread;) {
+        if constexpr (!Batched) {
+          queue.push(static_cast<long>(rng() % 1000000));
+          long value;
+          if (queue.try_pop(value))
+            sink += value;
+          i += 2;
+        } else {
+          in.clear();
+          out.clear();
+          for (size_t j = 0; j < batch; ++j)
+            in.push_back(static_cast<long>(rng() % 1000000));
+          queue.push(in.begin(), in.end());
+          queue.pop_n(std::back_inserter(out), batch);
+          for (long value : out)
+            sink += value;
+          i += 2 * batch;
+        }
+      }
+      sinks[t] = sink;
+    });
+  for (auto &th : threads)
+    th.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return static_cast<double>(num_threads) * ops_per_thread / seconds / 1e6;
+}
+
+int main() {
+  using queue = concurrent::priority_queue<long>;
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) * 2 && t <= 64; t *= 2)
+    thread_counts.push_back(t);
+
+  std::cout << "Scheduler workload (Mops/s)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "mutex+heap"
+            << std::setw(10) << "strict" << std::setw(16) << "strict batch"
+            << std::setw(10) << "relaxed" << std::endl;
+
+  for (int t : thread_counts)
+    std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+              << std::setw(14) << mops<locked_heap>(t) << std::setw(10)
+              << mops<queue>(t, concurrent::priority_order::strict)
+              << std::setw(16)
+              << mops<queue, true>(t, concurrent::priority_order::strict)
+              << std::setw(10)
+              << mops<queue>(t, concurrent::priority_order::relaxed)
+              << std::endl;
+
+  return 0;
+}
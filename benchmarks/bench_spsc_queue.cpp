@@ -0,0 +1,94 @@
+#include "../concurrent_mpmc_queue.h"
+#include "../concurrent_spsc_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// One producer thread handing items to one consumer thread: spsc_queue one
+// element and one batch at a time, against mpmc_queue used the same way.
+// On a machine with free cores the two threads run on different ones, which
+// is where the cached indices pay off.
+
+const long items = 20000000;
+const size_t capacity = 4096;
+
+template <typename Push, typename Pop> double mops(Push push, Pop pop) {
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&] {
+    for (long i = 0; i < items;) {
+      long pushed = push(i);
+      if (pushed)
+        i += pushed;
+      else
+        std::this_thread::yield();
+    }
+  });
+  long sum = 0;
+  for (long received = 0; received < items;) {
+    long got = pop(sum);
+    if (got)
+      received += got;
+    else
+      std::this_thread::yield();
+  }
+  producer.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  if (sum != items * (items - 1) / 2)
+    std::cout << "lost items!" << std::endl;
+  return items / seconds / 1e6;
+}
+
+template <typename Queue> double single(Queue &queue) {
+  return mops([&](long i) { return queue.try_push(i) ? 1L : 0L; },
+              [&](long &sum) {
+                long value;
+                if (!queue.try_pop(value))
+                  return 0L;
+                sum += value;
+                return 1L;
+              });
+}
+
+double batched(size_t batch) {
+  concurrent::spsc_queue<long> queue(capacity);
+  return mops(
+      [&](long i) {
+        long values[256];
+        size_t n = std::min<long>(batch, items - i);
+        for (size_t k = 0; k < n; ++k)
+          values[k] = i + static_cast<long>(k);
+        return static_cast<long>(queue.push_n(values, n));
+      },
+      [&](long &sum) {
+        long values[256];
+        size_t got = queue.pop_n(values, batch);
+        for (size_t k = 0; k < got; ++k)
+          sum += values[k];
+        return static_cast<long>(got);
+      });
+}
+
+int main() {
+  std::cout << "One producer, one consumer (M items/s)" << std::endl;
+  std::cout << std::setw(20) << "queue" << std::setw(12) << "rate"
+            << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+
+  concurrent::mpmc_queue<long> mpmc(capacity);
+  std::cout << std::setw(20) << "mpmc" << std::setw(12) << single(mpmc)
+            << std::endl;
+  concurrent::spsc_queue<long> spsc(capacity);
+  std::cout << std::setw(20) << "spsc" << std::setw(12) << single(spsc)
+            << std::endl;
+  for (size_t batch : {16, 64, 256})
+    std::cout << std::setw(20) << "spsc batch " + std::to_string(batch)
+              << std::setw(12) << batched(batch) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "../concurrent_vector.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Shared log workload: every thread appends records and reads back a record
+// appended earlier (one read per append). concurrent::vector against a
+// std::vector behind a std::shared_mutex, which has to take the exclusive lock
+// for every append and copies the whole array when it grows.
+
+const long appends_per_thread = 1000000;
+
+class locked_vector {
+  mutable std::shared_mutex _mutex;
+  std::vector<long> _data;
+
+public:
+  size_t push_back(long value) {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _data.push_back(value);
+    return _data.size() - 1;
+  }
+  long get(size_t index) const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _data[index];
+  }
+};
+
+struct segmented_vector {
+  concurrent::vector<long> data;
+
+  size_t push_back(long value) { return data.push_back(value); }
+  long get(size_t index) const { return data[index]; }
+};
+
+template <typename Vector> double mops(int num_threads) {
+  Vector v;
+  std::vector<std::thread> threads;
+  std::vector<long> sinks(num_threads);
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      long sink = 0;
+      for (long i = 0; i < appends_per_thread; ++i) {
+        size_t index = v.push_back(i);
+        sink += v.get(index / 2);
+      }
+      sinks[t] = sink;
+    });
+  for (auto &th : threads)
+    th.join();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return static_cast<double>(num_threads) * appends_per_thread / seconds / 1e6;
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts;
+  for (int t = 1; t <= static_cast<int>(hw ? hw : 1) * 2 && t <= 64; t *= 2)
+    thread_counts.push_back(t);
+
+  std::cout << "Append and read back (M appends/s)" << std::endl;
+  std::cout << std::setw(8) << "threads" << std::setw(24)
+            << "shared_mutex+vector" << std::setw(20) << "concurrent::vector"
+            << std::endl;
+
+  for (int t : thread_counts)
+    std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+              << std::setw(24) << mops<locked_vector>(t) << std::setw(20)
+              << mops<segmented_vector>(t) << std::endl;
+
+  return 0;
+}
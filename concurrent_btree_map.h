@@ -0,0 +1,497 @@
+#ifndef CONCURRENT_BTREE_MAP_H
+#define CONCURRENT_BTREE_MAP_H
+
+#include "internal/optimistic_lock.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+namespace internal {
+
+// Keys per node. With 8-byte keys the in-node search reads 8 cache lines
+// front to back, which hardware prefetchers handle well.
+inline constexpr std::size_t btree_leaf_capacity = 64;
+inline constexpr std::size_t btree_inner_capacity = 64;
+
+struct btree_node {
+  optimistic_lock lock;
+  const bool is_leaf;
+  std::atomic<std::uint32_t> count{0};
+
+  explicit btree_node(bool leaf) : is_leaf(leaf) {}
+};
+
+template <typename Key, typename Value> struct btree_leaf : btree_node {
+  std::atomic<Key> keys[btree_leaf_capacity];
+  std::atomic<Value> values[btree_leaf_capacity];
+  std::atomic<btree_leaf *> next{nullptr}; // Right sibling, for scans
+
+  btree_leaf() : btree_node(true) {}
+};
+
+// children[i] holds the keys in (keys[i - 1], keys[i]]
+template <typename Key> struct btree_inner : btree_node {
+  std::atomic<Key> keys[btree_inner_capacity];
+  std::atomic<btree_node *> children[btree_inner_capacity + 1];
+
+  btree_inner() : btree_node(false) {}
+};
+
+// Index of the first of the n sorted keys not below key. Optimistic readers
+// may see a node mid-update, so any answer in [0, n] must be safe to use
+// until validation throws it away.
+template <typename Key, typename Compare>
+std::size_t btree_search(const std::atomic<Key> *keys, std::size_t n,
+                         const Key &key, const Compare &less) {
+  if constexpr (std::is_arithmetic_v<Key> &&
+                std::is_same_v<Compare, std::less<Key>>) {
+    // Counting the smaller keys has no data-dependent branches; on a node of
+    // a few cache lines it beats a binary search's mispredictions
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      pos += keys[i].load(std::memory_order_relaxed) < key;
+    return pos;
+  } else {
+    std::size_t first = 0;
+    while (n > 0) {
+      std::size_t half = n / 2;
+      if (less(keys[first + half].load(std::memory_order_relaxed), key)) {
+        first += half + 1;
+        n -= half + 1;
+      } else {
+        n = half;
+      }
+    }
+    return first;
+  }
+}
+
+} // namespace internal
+
+// Ordered map for large concurrent indexes: a B+-tree with wide nodes,
+// synchronized by optimistic lock coupling.
+//
+// Readers take no locks and write nothing shared. They descend while
+// checking each node's version; a concurrent change to a node they read
+// makes them restart. Writers lock only the leaf they change, plus its
+// parent when the leaf splits. Full nodes are split on the way down, so a
+// split never has to propagate upwards.
+//
+// Keys and values are stored in std::atomic cells so that optimistic reads
+// are race-free, which requires trivially copyable, lock-free types (integers,
+// pointers, small structs). Erase does not merge nodes: they are reused by
+// later inserts and released with the map.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class btree_map {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<Value>,
+                "btree_map keys and values must be trivially copyable");
+  static_assert(std::atomic<Key>::is_always_lock_free &&
+                    std::atomic<Value>::is_always_lock_free,
+                "btree_map keys and values must fit in a lock-free atomic");
+
+  using node = internal::btree_node;
+  using leaf = internal::btree_leaf<Key, Value>;
+  using inner = internal::btree_inner<Key>;
+  static constexpr std::size_t leaf_capacity = internal::btree_leaf_capacity;
+  static constexpr std::size_t inner_capacity = internal::btree_inner_capacity;
+
+  std::atomic<node *> _root;
+  Compare _less;
+  std::atomic<size_t> _size{0};
+
+  static constexpr int restart = -1;
+
+  static size_t clamp(const node *n, size_t capacity) {
+    size_t count = n->count.load(std::memory_order_relaxed);
+    return count < capacity ? count : capacity;
+  }
+
+  size_t search(const std::atomic<Key> *keys, size_t n, const Key &key) const {
+    return internal::btree_search(keys, n, key, _less);
+  }
+
+  bool equal(const Key &a, const Key &b) const {
+    return !_less(a, b) && !_less(b, a);
+  }
+
+  // Optimistic descent to the leaf holding key (the leftmost leaf if key is
+  // null). On success lf and version describe a leaf read with read_begin()
+  // and parent links that were still valid when it was reached.
+  bool descend(const Key *key, leaf *&lf, std::uint64_t &version) const {
+    node *current = _root.load(std::memory_order_acquire);
+    std::uint64_t v = current->lock.read_begin();
+    if (current != _root.load(std::memory_order_acquire))
+      return false;
+    while (!current->is_leaf) {
+      auto *in = static_cast<inner *>(current);
+      size_t pos = key ? search(in->keys, clamp(in, inner_capacity), *key) : 0;
+      node *child = in->children[pos].load(std::memory_order_relaxed);
+      if (!in->lock.validate(v))
+        return false;
+      // Nodes are never freed while the map lives, so the child can be read
+      // even if the parent changed since. Checking the parent again once the
+      // child's version is taken rules out a split of the child in between,
+      // which could have moved key to a new sibling.
+      std::uint64_t parent_version = v;
+      current = child;
+      v = current->lock.read_begin();
+      if (!in->lock.validate(parent_version))
+        return false;
+    }
+    lf = static_cast<leaf *>(current);
+    version = v;
+    return true;
+  }
+
+  // Split helpers; the caller holds the write locks of the node and its
+  // parent (if any)
+  inner *split_inner(inner *in, Key &separator) {
+    size_t n = in->count.load(std::memory_order_relaxed);
+    size_t mid = n / 2;
+    auto *right = new inner();
+    separator = in->keys[mid].load(std::memory_order_relaxed);
+    for (size_t i = mid + 1; i < n; ++i)
+      right->keys[i - mid - 1].store(
+          in->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    for (size_t i = mid + 1; i <= n; ++i)
+      right->children[i - mid - 1].store(
+          in->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    right->count.store(static_cast<std::uint32_t>(n - mid - 1),
+                       std::memory_order_relaxed);
+    in->count.store(static_cast<std::uint32_t>(mid), std::memory_order_relaxed);
+    return right;
+  }
+
+  leaf *split_leaf(leaf *lf, Key &separator) {
+    size_t n = lf->count.load(std::memory_order_relaxed);
+    size_t left = n / 2;
+    auto *right = new leaf();
+    for (size_t i = left; i < n; ++i) {
+      right->keys[i - left].store(lf->keys[i].load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+      right->values[i - left].store(
+          lf->values[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    right->count.store(static_cast<std::uint32_t>(n - left),
+                       std::memory_order_relaxed);
+    right->next.store(lf->next.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    lf->count.store(static_cast<std::uint32_t>(left),
+                    std::memory_order_relaxed);
+    lf->next.store(right, std::memory_order_relaxed);
+    separator = lf->keys[left - 1].load(std::memory_order_relaxed);
+    return right;
+  }
+
+  void insert_child(inner *parent, const Key &separator, node *right) {
+    size_t n = parent->count.load(std::memory_order_relaxed);
+    size_t pos = search(parent->keys, n, separator);
+    for (size_t i = n; i > pos; --i) {
+      parent->keys[i].store(parent->keys[i - 1].load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+      parent->children[i + 1].store(
+          parent->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    parent->keys[pos].store(separator, std::memory_order_relaxed);
+    parent->children[pos + 1].store(right, std::memory_order_relaxed);
+    parent->count.store(static_cast<std::uint32_t>(n + 1),
+                        std::memory_order_relaxed);
+  }
+
+  void make_root(const Key &separator, node *left, node *right) {
+    auto *root = new inner();
+    root->keys[0].store(separator, std::memory_order_relaxed);
+    root->children[0].store(left, std::memory_order_relaxed);
+    root->children[1].store(right, std::memory_order_relaxed);
+    root->count.store(1, std::memory_order_relaxed);
+    _root.store(root, std::memory_order_release);
+  }
+
+  // Split n, whose version is v, under its parent (version pv, or null for
+  // the root). Always ends in a restart of the caller's descent.
+  template <typename Split>
+  void split_node(node *n, std::uint64_t v, inner *parent, std::uint64_t pv,
+                  Split &&split) {
+    if (parent && !parent->lock.try_upgrade(pv))
+      return;
+    if (!n->lock.try_upgrade(v)) {
+      if (parent)
+        parent->lock.unlock();
+      return;
+    }
+    // A root that got a parent meanwhile has to be split through it
+    if (!parent && n != _root.load(std::memory_order_relaxed)) {
+      n->lock.unlock();
+      return;
+    }
+    Key separator;
+    node *right = split(separator);
+    if (parent)
+      insert_child(parent, separator, right);
+    else
+      make_root(separator, n, right);
+    n->lock.unlock();
+    if (parent)
+      parent->lock.unlock();
+  }
+
+  // Descend to key's leaf and return it write-locked, splitting full nodes
+  // on the way if grow is set. Null means restart.
+  leaf *lock_leaf(const Key &key, bool grow) {
+    node *current = _root.load(std::memory_order_acquire);
+    std::uint64_t v = current->lock.read_begin();
+    if (current != _root.load(std::memory_order_acquire))
+      return nullptr;
+    inner *parent = nullptr;
+    std::uint64_t pv = 0;
+    while (!current->is_leaf) {
+      auto *in = static_cast<inner *>(current);
+      if (grow && in->count.load(std::memory_order_relaxed) == inner_capacity) {
+        split_node(in, v, parent, pv,
+                   [&](Key &separator) { return split_inner(in, separator); });
+        return nullptr;
+      }
+      if (parent && !parent->lock.validate(pv))
+        return nullptr;
+      parent = in;
+      pv = v;
+      size_t pos = search(in->keys, clamp(in, inner_capacity), key);
+      node *child = in->children[pos].load(std::memory_order_relaxed);
+      if (!in->lock.validate(v))
+        return nullptr;
+      current = child;
+      v = current->lock.read_begin();
+    }
+    auto *lf = static_cast<leaf *>(current);
+    if (grow && lf->count.load(std::memory_order_relaxed) == leaf_capacity) {
+      split_node(lf, v, parent, pv,
+                 [&](Key &separator) { return split_leaf(lf, separator); });
+      return nullptr;
+    }
+    if (!lf->lock.try_upgrade(v))
+      return nullptr;
+    if (parent && !parent->lock.validate(pv)) {
+      lf->lock.unlock();
+      return nullptr;
+    }
+    return lf;
+  }
+
+  int try_insert(const Key &key, const Value &value, bool assign) {
+    leaf *lf = lock_leaf(key, true);
+    if (!lf)
+      return restart;
+    size_t n = lf->count.load(std::memory_order_relaxed);
+    size_t pos = search(lf->keys, n, key);
+    if (pos < n && equal(lf->keys[pos].load(std::memory_order_relaxed), key)) {
+      if (assign)
+        lf->values[pos].store(value, std::memory_order_relaxed);
+      lf->lock.unlock();
+      return 0;
+    }
+    for (size_t i = n; i > pos; --i) {
+      lf->keys[i].store(lf->keys[i - 1].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+      lf->values[i].store(lf->values[i - 1].load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    }
+    lf->keys[pos].store(key, std::memory_order_relaxed);
+    lf->values[pos].store(value, std::memory_order_relaxed);
+    lf->count.store(static_cast<std::uint32_t>(n + 1),
+                    std::memory_order_relaxed);
+    lf->lock.unlock();
+    _size.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+  }
+
+  // Visit elements from key (or the first one) onwards, in order, until
+  // f(key, value) returns false. Each leaf is copied out and validated
+  // before f sees any of it, so f runs without locks and may call back into
+  // the map; after a conflict the scan resumes behind the last key passed.
+  template <typename F> void scan(const Key *from, F &&f) const {
+    Key position{};
+    bool started = false; // position holds the last key passed to f
+    if (from)
+      position = *from;
+    std::pair<Key, Value> batch[leaf_capacity];
+    for (;;) {
+      leaf *lf;
+      std::uint64_t v;
+      if (!descend(from || started ? &position : nullptr, lf, v))
+        continue;
+      for (;;) {
+        size_t n = clamp(lf, leaf_capacity);
+        size_t pos = from || started ? search(lf->keys, n, position) : 0;
+        size_t count = 0;
+        for (; pos < n; ++pos) {
+          Key key = lf->keys[pos].load(std::memory_order_relaxed);
+          if (started && !_less(position, key))
+            continue;
+          batch[count++] = {key,
+                            lf->values[pos].load(std::memory_order_relaxed)};
+        }
+        leaf *next = lf->next.load(std::memory_order_relaxed);
+        if (!lf->lock.validate(v))
+          break; // Descend again from position
+        for (size_t i = 0; i < count; ++i) {
+          if (!f(batch[i].first, batch[i].second))
+            return;
+          position = batch[i].first;
+          started = true;
+        }
+        if (!next)
+          return;
+        lf = next;
+        v = lf->lock.read_begin();
+      }
+    }
+  }
+
+  static void destroy(node *n) {
+    if (!n->is_leaf) {
+      auto *in = static_cast<inner *>(n);
+      size_t count = in->count.load(std::memory_order_relaxed);
+      for (size_t i = 0; i <= count; ++i)
+        destroy(in->children[i].load(std::memory_order_relaxed));
+      delete in;
+    } else {
+      delete static_cast<leaf *>(n);
+    }
+  }
+
+public:
+  explicit btree_map(const Compare &comp = Compare())
+      : _root(new leaf()), _less(comp) {}
+
+  btree_map(const btree_map &) = delete;
+  btree_map &operator=(const btree_map &) = delete;
+
+  /// No thread may be using the map
+  ~btree_map() { destroy(_root.load(std::memory_order_relaxed)); }
+
+  /// Returns false, leaving the map unchanged, if key is already present
+  bool insert(const Key &key, const Value &value) {
+    int result;
+    while ((result = try_insert(key, value, false)) == restart) {
+    }
+    return result == 1;
+  }
+
+  /// Returns true if key was inserted, false if its value was replaced
+  bool insert_or_assign(const Key &key, const Value &value) {
+    int result;
+    while ((result = try_insert(key, value, true)) == restart) {
+    }
+    return result == 1;
+  }
+
+  size_t erase(const Key &key) {
+    leaf *lf;
+    while (!(lf = lock_leaf(key, false))) {
+    }
+    size_t n = lf->count.load(std::memory_order_relaxed);
+    size_t pos = search(lf->keys, n, key);
+    if (pos == n ||
+        !equal(lf->keys[pos].load(std::memory_order_relaxed), key)) {
+      lf->lock.unlock();
+      return 0;
+    }
+    for (size_t i = pos + 1; i < n; ++i) {
+      lf->keys[i - 1].store(lf->keys[i].load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+      lf->values[i - 1].store(lf->values[i].load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+    }
+    lf->count.store(static_cast<std::uint32_t>(n - 1),
+                    std::memory_order_relaxed);
+    lf->lock.unlock();
+    _size.fetch_sub(1, std::memory_order_relaxed);
+    return 1;
+  }
+
+  std::optional<Value> find(const Key &key) const {
+    for (;;) {
+      leaf *lf;
+      std::uint64_t v;
+      if (!descend(&key, lf, v))
+        continue;
+      size_t n = clamp(lf, leaf_capacity);
+      size_t pos = search(lf->keys, n, key);
+      std::optional<Value> result;
+      if (pos < n && equal(lf->keys[pos].load(std::memory_order_relaxed), key))
+        result = lf->values[pos].load(std::memory_order_relaxed);
+      if (lf->lock.validate(v))
+        return result;
+    }
+  }
+
+  bool contains(const Key &key) const { return find(key).has_value(); }
+
+  /// First element with a key not below key
+  std::optional<std::pair<Key, Value>> lower_bound(const Key &key) const {
+    std::optional<std::pair<Key, Value>> result;
+    scan(&key, [&](const Key &k, const Value &v) {
+      result.emplace(k, v);
+      return false;
+    });
+    return result;
+  }
+
+  /// Call f(key, value) for the elements with keys in [first, last), in key
+  /// order. f gets copies and runs without any lock held. Weakly consistent:
+  /// elements present for the whole scan are seen exactly once, concurrent
+  /// changes may or may not be.
+  template <typename F>
+  void for_each_range(const Key &first, const Key &last, F &&f) const {
+    scan(&first, [&](const Key &k, const Value &v) {
+      if (!_less(k, last))
+        return false;
+      f(k, v);
+      return true;
+    });
+  }
+
+  /// Same over the whole map
+  template <typename F> void for_each(F &&f) const {
+    scan(nullptr, [&](const Key &k, const Value &v) {
+      f(k, v);
+      return true;
+    });
+  }
+
+  std::vector<std::pair<Key, Value>> range(const Key &first,
+                                           const Key &last) const {
+    std::vector<std::pair<Key, Value>> data;
+    for_each_range(first, last, [&](const Key &k, const Value &v) {
+      data.emplace_back(k, v);
+    });
+    return data;
+  }
+
+  std::vector<std::pair<Key, Value>> snapshot() const {
+    std::vector<std::pair<Key, Value>> data;
+    data.reserve(size());
+    for_each([&](const Key &k, const Value &v) { data.emplace_back(k, v); });
+    return data;
+  }
+
+  /// Exact when no insert or erase is in progress
+  size_t size() const { return _size.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_BTREE_MAP_H
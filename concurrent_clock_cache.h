@@ -0,0 +1,209 @@
+#ifndef CONCURRENT_CLOCK_CACHE_H
+#define CONCURRENT_CLOCK_CACHE_H
+
+#include "concurrent_hash.h"
+#include "internal/container_base.h"
+#include "internal/map_backend.h"
+#include "internal/sharded.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+// Bounded cache with CLOCK (second chance) eviction, a cheaper stand-in for
+// lru_cache with a similar hit ratio on skewed workloads.
+//
+// Each shard keeps its entries in a fixed ring of slots, indexed by a table
+// of the same engine as unordered_map. A hit takes the shard's shared lock
+// and sets the slot's reference bit, and nothing else: no list to reorder,
+// no buffer to fill. When a full shard needs room, its hand sweeps the
+// ring, clearing reference bits, and evicts the first entry that was not
+// referenced since the hand last passed it.
+template <typename Key, typename Value, typename Hash = concurrent::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class clock_cache {
+  struct slot {
+    std::optional<std::pair<Key, Value>> item;
+    std::atomic<bool> referenced{false};
+  };
+
+  using table_type =
+      internal::map_backend_t<Key, size_t, Hash, KeyEqual,
+                              std::allocator<std::pair<const Key, size_t>>>;
+
+  struct shard_state {
+    table_type index; // Key to slot
+    std::unique_ptr<slot[]> ring;
+    size_t capacity = 0;
+    size_t used = 0;            // Slots [0, used) have been filled once
+    std::vector<size_t> erased; // Slots emptied by erase(), reused first
+    size_t hand = 0;
+  };
+
+  using shard = internal::container_base<shard_state>;
+
+  internal::sharded<shard> _shards;
+  size_t _capacity;
+  Hash _hasher;
+
+  shard &shard_for(const Key &key) { return _shards.for_hash(_hasher(key)); }
+  const shard &shard_for(const Key &key) const {
+    return const_cast<clock_cache *>(this)->shard_for(key);
+  }
+
+  static void touch(slot &s) noexcept {
+    // Skip the store when the bit is already set, so that hot entries do not
+    // keep writing to their cache line
+    if (!s.referenced.load(std::memory_order_relaxed))
+      s.referenced.store(true, std::memory_order_relaxed);
+  }
+
+  // Slot for a new entry: a free one, or the first unreferenced one under
+  // the hand, whose entry is evicted. Exclusive lock held.
+  static size_t claim_slot(shard_state &state) {
+    if (!state.erased.empty()) {
+      size_t index = state.erased.back();
+      state.erased.pop_back();
+      return index;
+    }
+    if (state.used < state.capacity)
+      return state.used++;
+    for (;;) {
+      slot &s = state.ring[state.hand];
+      size_t index = state.hand;
+      state.hand = state.hand + 1 == state.capacity ? 0 : state.hand + 1;
+      if (s.referenced.load(std::memory_order_relaxed)) {
+        s.referenced.store(false, std::memory_order_relaxed);
+        continue;
+      }
+      state.index.erase(s.item->first);
+      s.item.reset();
+      return index;
+    }
+  }
+
+  template <typename K, typename V> bool put_impl(K &&key, V &&value) {
+    return shard_for(key).execute_exclusive([&](shard_state &state) {
+      auto it = state.index.find(key);
+      if (it != state.index.end()) {
+        slot &s = state.ring[it->second];
+        s.item->second = std::forward<V>(value);
+        touch(s);
+        return false;
+      }
+      size_t index = claim_slot(state);
+      slot &s = state.ring[index];
+      try {
+        s.item.emplace(key, std::forward<V>(value));
+        state.index.try_emplace(std::forward<K>(key), index);
+      } catch (...) {
+        s.item.reset();
+        state.erased.push_back(index);
+        throw;
+      }
+      // New entries start unreferenced: a key read only once is the first
+      // to go
+      s.referenced.store(false, std::memory_order_relaxed);
+      return true;
+    });
+  }
+
+public:
+  /// At most capacity entries (at least one), spread over shards shards
+  /// (rounded up to a power of two, but no more than capacity; 0 picks a
+  /// count from the capacity and the core count). Each shard evicts on its
+  /// own once it holds its share of capacity.
+  explicit clock_cache(size_t capacity, size_t shards = 0,
+                       const Hash &hash = Hash())
+      : _shards(internal::cache_shard_count(capacity, shards)),
+        _capacity(capacity), _hasher(hash) {
+    for (size_t i = 0; i < _shards.size(); ++i) {
+      size_t share = internal::shard_capacity(capacity, _shards.size(), i);
+      _shards[i].execute_exclusive([&](shard_state &state) {
+        state.ring.reset(new slot[share]);
+        state.capacity = share;
+        state.index.reserve(share);
+      });
+    }
+  }
+
+  clock_cache(const clock_cache &) = delete;
+  clock_cache &operator=(const clock_cache &) = delete;
+
+  /// Copy of the cached value, counted as a use of the entry. Takes only
+  /// the shard's shared lock.
+  std::optional<Value> get(const Key &key) {
+    return shard_for(key).execute_shared(
+        [&](const shard_state &state) -> std::optional<Value> {
+          auto it = state.index.find(key);
+          if (it == state.index.end())
+            return std::nullopt;
+          slot &s = state.ring[it->second];
+          touch(s);
+          return s.item->second;
+        });
+  }
+
+  /// Insert or replace the value of key, evicting an entry of the shard
+  /// if it is full. Returns true if key was not cached before.
+  bool put(const Key &key, const Value &value) { return put_impl(key, value); }
+  bool put(Key &&key, Value &&value) {
+    return put_impl(std::move(key), std::move(value));
+  }
+
+  /// Lookup that does not count as a use
+  bool contains(const Key &key) const {
+    return shard_for(key).execute_shared([&](const shard_state &state) {
+      return state.index.find(key) != state.index.end();
+    });
+  }
+
+  size_t erase(const Key &key) {
+    return shard_for(key).execute_exclusive([&](shard_state &state) {
+      auto it = state.index.find(key);
+      if (it == state.index.end())
+        return size_t(0);
+      size_t index = it->second;
+      state.index.erase(it);
+      state.ring[index].item.reset();
+      state.erased.push_back(index);
+      return size_t(1);
+    });
+  }
+
+  void clear() {
+    _shards.for_each([](shard &s) {
+      s.execute_exclusive([](shard_state &state) {
+        for (size_t i = 0; i < state.used; ++i)
+          state.ring[i].item.reset();
+        state.index.clear();
+        state.erased.clear();
+        state.used = 0;
+        state.hand = 0;
+      });
+    });
+  }
+
+  size_t size() const {
+    size_t total = 0;
+    _shards.for_each([&](const shard &s) {
+      total += s.execute_shared(
+          [](const shard_state &state) { return state.index.size(); });
+    });
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+  size_t capacity() const noexcept { return _capacity; }
+  size_t shard_count() const noexcept { return _shards.size(); }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_CLOCK_CACHE_H
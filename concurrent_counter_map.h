@@ -0,0 +1,242 @@
+#ifndef CONCURRENT_COUNTER_MAP_H
+#define CONCURRENT_COUNTER_MAP_H
+
+#include "concurrent_hash.h"
+#include "internal/container_base.h"
+#include "internal/striped.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+namespace internal {
+
+template <typename Integral> struct counter_stripe {
+  std::atomic<Integral> value{0};
+};
+
+template <typename Integral>
+using counter_stripes = striped<counter_stripe<Integral>>;
+
+// A counter, optionally split into per-thread stripes. stripes is only set
+// under the exclusive lock, so readers under the shared lock see it stable.
+template <typename Integral> struct counter_cell {
+  using stripe = counter_stripe<Integral>;
+
+  std::atomic<Integral> value;
+  std::shared_ptr<counter_stripes<Integral>> stripes;
+
+  explicit counter_cell(Integral initial) : value(initial) {}
+
+  // New value, or nothing when striped: it is then only known by summing
+  std::optional<Integral> add(Integral delta) {
+    if (stripes) {
+      stripes->local().value.fetch_add(delta, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    return value.fetch_add(delta, std::memory_order_relaxed) + delta;
+  }
+
+  Integral load() const {
+    Integral sum = value.load(std::memory_order_relaxed);
+    if (stripes)
+      stripes->for_each([&](const stripe &s) {
+        sum += s.value.load(std::memory_order_relaxed);
+      });
+    return sum;
+  }
+
+  // Each part is exchanged atomically, so no concurrent update is lost
+  Integral exchange_zero() {
+    Integral sum = value.exchange(0, std::memory_order_relaxed);
+    if (stripes)
+      stripes->for_each([&](stripe &s) {
+        sum += s.value.exchange(0, std::memory_order_relaxed);
+      });
+    return sum;
+  }
+};
+
+} // namespace internal
+
+// Direct handle to a striped counter_map counter, returned by stripe().
+// Updates through it take no lock at all, not even the map's shared one.
+// The handle stays valid after the key is erased, but then counts into a
+// counter the map no longer sees.
+template <typename Integral> class hot_counter {
+  std::shared_ptr<internal::counter_stripes<Integral>> _stripes;
+
+public:
+  explicit hot_counter(
+      std::shared_ptr<internal::counter_stripes<Integral>> stripes)
+      : _stripes(std::move(stripes)) {}
+
+  void add(Integral delta = 1) {
+    _stripes->local().value.fetch_add(delta, std::memory_order_relaxed);
+  }
+  void increment() { add(1); }
+  void decrement() { add(Integral(-1)); }
+};
+
+// Map from keys to integer counters. Counters of existing keys are updated
+// with atomic read-modify-write operations under the shared lock, so
+// increments from many threads proceed in parallel; only the first update
+// of a new key takes the exclusive lock to insert it.
+//
+// Updates use relaxed ordering: a counter is exact, but its value does not
+// order other memory operations.
+//
+// A few very hot keys still make every core fight over one cache line (and
+// over the lock's). stripe(key) splits such a counter into per-thread,
+// cache-line padded stripes that are summed on read, and returns a handle
+// that updates them without locking.
+template <typename Key, typename Integral = long,
+          typename Hash = concurrent::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename MutexT = std::shared_mutex>
+class counter_map
+    : public internal::container_base<
+          std::unordered_map<Key, internal::counter_cell<Integral>, Hash,
+                             KeyEqual>,
+          MutexT> {
+  static_assert(std::is_integral_v<Integral>,
+                "counter_map values must be integers");
+
+  using cell_type = internal::counter_cell<Integral>;
+  // Node-based: atomics cannot be moved, and a node never moves on rehash
+  using internal_type = std::unordered_map<Key, cell_type, Hash, KeyEqual>;
+  using Base = internal::container_base<internal_type, MutexT>;
+
+public:
+  template <typename... Args>
+  explicit counter_map(Args &&...args) : Base(std::forward<Args>(args)...) {}
+
+  // Add delta to the counter of key, creating it at zero first if needed.
+  // Returns the new value, or std::nullopt for striped counters: their value
+  // is only known by summing the stripes, which is what striping avoids on
+  // this path. Read them with get().
+  std::optional<Integral> add(const Key &key, Integral delta = 1) {
+    bool found = false;
+    std::optional<Integral> updated = this->execute_shared(
+        [&](const internal_type &m) -> std::optional<Integral> {
+          auto it = m.find(key);
+          if (it == m.end())
+            return std::nullopt;
+          found = true;
+          return cell(it).add(delta);
+        });
+    if (found)
+      return updated;
+    return this->execute_exclusive([&](internal_type &m) {
+      return m.try_emplace(key, 0).first->second.add(delta);
+    });
+  }
+
+  std::optional<Integral> increment(const Key &key) { return add(key, 1); }
+  std::optional<Integral> decrement(const Key &key) {
+    return add(key, Integral(-1));
+  }
+
+  // Current value, if the key has a counter
+  std::optional<Integral> find(const Key &key) const {
+    return this->execute_shared(
+        [&](const internal_type &m) -> std::optional<Integral> {
+          auto it = m.find(key);
+          if (it == m.end())
+            return std::nullopt;
+          return it->second.load();
+        });
+  }
+
+  // Current value, 0 for keys without a counter
+  Integral get(const Key &key) const { return find(key).value_or(0); }
+
+  // Set the counter of an existing key to zero and return its old value,
+  // e.g. to report and restart a rate every interval. Keeps the key, so the
+  // next add() stays on the shared path.
+  Integral reset(const Key &key) {
+    return this->execute_shared([&](const internal_type &m) {
+      auto it = m.find(key);
+      if (it == m.end())
+        return Integral(0);
+      return cell(it).exchange_zero();
+    });
+  }
+
+  // Split the counter of key (created at zero if needed) into per-thread
+  // stripes, so that threads incrementing it no longer share a cache line.
+  // Costs a cache line per hardware thread; meant for a handful of hot keys.
+  // add() keeps working on the key; the returned handle skips the lookup and
+  // the lock.
+  hot_counter<Integral> stripe(const Key &key) {
+    return this->execute_exclusive([&](internal_type &m) {
+      cell_type &c = m.try_emplace(key, 0).first->second;
+      if (!c.stripes)
+        c.stripes = std::make_shared<internal::counter_stripes<Integral>>();
+      return hot_counter<Integral>(c.stripes);
+    });
+  }
+
+  bool is_striped(const Key &key) const {
+    return this->execute_shared([&](const internal_type &m) {
+      auto it = m.find(key);
+      return it != m.end() && it->second.stripes != nullptr;
+    });
+  }
+
+  size_t erase(const Key &key) {
+    return this->execute_exclusive(
+        [&](internal_type &m) { return m.erase(key); });
+  }
+
+  void clear() {
+    this->execute_exclusive([](internal_type &m) { m.clear(); });
+  }
+
+  bool contains(const Key &key) const {
+    return this->execute_shared(
+        [&](const internal_type &m) { return m.count(key) > 0; });
+  }
+
+  // Sum of all counters
+  Integral total() const {
+    return this->execute_shared([](const internal_type &m) {
+      Integral sum = 0;
+      for (const auto &pair : m)
+        sum += pair.second.load();
+      return sum;
+    });
+  }
+
+  // Counters may still change while the snapshot is taken, so the values are
+  // not a consistent cut across keys, but every key present is included
+  std::vector<std::pair<Key, Integral>> snapshot() const {
+    return this->execute_shared([](const internal_type &m) {
+      std::vector<std::pair<Key, Integral>> data;
+      data.reserve(m.size());
+      for (const auto &pair : m)
+        data.emplace_back(pair.first, pair.second.load());
+      return data;
+    });
+  }
+
+  // size(), empty(), execute_shared and execute_exclusive inherited from base
+
+private:
+  // The shared lock only guards the table; the counters themselves are
+  // atomics and may be modified through a const view of it
+  static cell_type &cell(typename internal_type::const_iterator it) {
+    return const_cast<cell_type &>(it->second);
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_COUNTER_MAP_H
@@ -0,0 +1,132 @@
+#ifndef CONCURRENT_COUNTING_ALLOCATOR_H
+#define CONCURRENT_COUNTING_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace concurrent {
+
+/// Byte counter shared by all copies of a counting_allocator. Can enforce a
+/// budget: allocations that would exceed the limit throw std::bad_alloc.
+class allocation_counter {
+  std::atomic<size_t> _bytes{0};
+  std::atomic<size_t> _peak{0};
+  std::atomic<size_t> _allocations{0};
+  size_t _limit;
+
+public:
+  explicit allocation_counter(
+      size_t limit = std::numeric_limits<size_t>::max())
+      : _limit(limit) {}
+
+  allocation_counter(const allocation_counter &) = delete;
+  allocation_counter &operator=(const allocation_counter &) = delete;
+
+  void on_allocate(size_t bytes) {
+    size_t current = _bytes.load(std::memory_order_relaxed);
+    do {
+      if (bytes > _limit - current)
+        throw std::bad_alloc();
+    } while (!_bytes.compare_exchange_weak(current, current + bytes,
+                                           std::memory_order_relaxed));
+    size_t now = current + bytes;
+    size_t peak = _peak.load(std::memory_order_relaxed);
+    while (now > peak &&
+           !_peak.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+      ;
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_deallocate(size_t bytes) noexcept {
+    _bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    _allocations.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Bytes currently allocated
+  size_t bytes() const { return _bytes.load(std::memory_order_relaxed); }
+  /// Highest value bytes() has reached
+  size_t peak() const { return _peak.load(std::memory_order_relaxed); }
+  /// Allocations currently live
+  size_t allocations() const {
+    return _allocations.load(std::memory_order_relaxed);
+  }
+  size_t limit() const { return _limit; }
+};
+
+/// Allocator adaptor reporting every allocation of Base to an
+/// allocation_counter. Give each tenant its own counter to track or cap its
+/// maps:
+///
+///   concurrent::allocation_counter tenant(64 << 20);
+///   using alloc = concurrent::counting_allocator<std::pair<const int, int>>;
+///   concurrent::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+///                             alloc> map(alloc(&tenant));
+template <typename T, typename Base = std::allocator<T>>
+class counting_allocator {
+  template <typename U, typename B> friend class counting_allocator;
+
+  using base_traits = std::allocator_traits<Base>;
+
+  allocation_counter *_counter;
+  Base _base;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U> struct rebind {
+    using other = counting_allocator<
+        U, typename base_traits::template rebind_alloc<U>>;
+  };
+
+  explicit counting_allocator(allocation_counter *counter,
+                              const Base &base = Base()) noexcept
+      : _counter(counter), _base(base) {}
+
+  template <typename U, typename B>
+  counting_allocator(const counting_allocator<U, B> &other) noexcept
+      : _counter(other._counter), _base(other._base) {}
+
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    _counter->on_allocate(n * sizeof(T));
+    try {
+      return base_traits::allocate(_base, n);
+    } catch (...) {
+      _counter->on_deallocate(n * sizeof(T));
+      throw;
+    }
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    base_traits::deallocate(_base, p, n);
+    _counter->on_deallocate(n * sizeof(T));
+  }
+
+  allocation_counter *counter() const noexcept { return _counter; }
+  const Base &base() const noexcept { return _base; }
+
+  template <typename U, typename B>
+  bool operator==(const counting_allocator<U, B> &other) const noexcept {
+    return _counter == other._counter && _base == other._base;
+  }
+
+  template <typename U, typename B>
+  bool operator!=(const counting_allocator<U, B> &other) const noexcept {
+    return !(*this == other);
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_COUNTING_ALLOCATOR_H
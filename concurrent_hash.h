@@ -0,0 +1,95 @@
+#ifndef CONCURRENT_HASH_H
+#define CONCURRENT_HASH_H
+
+#include "internal/hash_functions.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace concurrent {
+
+// Default hash of the concurrent containers.
+//
+// std::hash is the identity for integers on libstdc++ and libc++, which is
+// fine for prime bucket counts but clusters badly under power-of-two
+// sharding or open addressing. concurrent::hash mixes integers, enums and
+// pointers with a multiply-fold and hashes strings with wyhash; every other
+// type falls back to std::hash.
+//
+// Specializations that distribute well on every bit declare is_avalanching,
+// so tables can use the low bits directly.
+template <typename T, typename Enable = void> struct hash : std::hash<T> {};
+
+template <typename T>
+struct hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T> ||
+                                std::is_pointer_v<T>>> {
+  using is_avalanching = void;
+
+  size_t operator()(T value) const noexcept {
+    uint64_t bits;
+    if constexpr (std::is_pointer_v<T>)
+      bits = reinterpret_cast<uintptr_t>(value);
+    else
+      bits = static_cast<uint64_t>(value);
+    return static_cast<size_t>(internal::hash_mix(bits));
+  }
+};
+
+template <typename CharT, typename Traits>
+struct hash<std::basic_string_view<CharT, Traits>> {
+  using is_avalanching = void;
+  using is_transparent = void;
+
+  size_t operator()(std::basic_string_view<CharT, Traits> s) const noexcept {
+    return static_cast<size_t>(
+        internal::hash_bytes(s.data(), s.size() * sizeof(CharT)));
+  }
+};
+
+template <typename CharT, typename Traits, typename Allocator>
+struct hash<std::basic_string<CharT, Traits, Allocator>>
+    : hash<std::basic_string_view<CharT, Traits>> {};
+
+// Keyed hash for keys chosen by an adversary. Every default-constructed
+// instance draws a random seed, so each map gets its own hash function and
+// collisions found against one map (or one process) do not carry over.
+// Containers rebuild with a new seed when a chain grows suspiciously long.
+//
+// Types without a specialization above are seeded on top of std::hash,
+// which only helps if std::hash itself does not collide.
+template <typename T> class seeded_hash {
+  uint64_t _seed;
+
+public:
+  using is_avalanching = void;
+  using is_seeded = void;
+
+  seeded_hash() : _seed(internal::random_seed()) {}
+  explicit seeded_hash(uint64_t seed) : _seed(seed) {}
+
+  uint64_t seed() const noexcept { return _seed; }
+
+  size_t operator()(const T &value) const noexcept {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+      return static_cast<size_t>(
+          internal::hash_mix(static_cast<uint64_t>(value), _seed));
+    } else if constexpr (std::is_pointer_v<T>) {
+      return static_cast<size_t>(
+          internal::hash_mix(reinterpret_cast<uintptr_t>(value), _seed));
+    } else if constexpr (std::is_convertible_v<const T &,
+                                               std::string_view>) {
+      std::string_view s = value;
+      return static_cast<size_t>(internal::hash_bytes(s.data(), s.size(), _seed));
+    } else {
+      return static_cast<size_t>(
+          internal::hash_mix(std::hash<T>()(value), _seed));
+    }
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_HASH_H
@@ -0,0 +1,197 @@
+#ifndef CONCURRENT_LRU_CACHE_H
+#define CONCURRENT_LRU_CACHE_H
+
+#include "concurrent_hash.h"
+#include "concurrent_mpmc_queue.h"
+#include "internal/container_base.h"
+#include "internal/map_backend.h"
+#include "internal/sharded.h"
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+namespace concurrent {
+
+// Bounded cache evicting the least recently used entry, split into shards
+// that each keep their own LRU list and hold an equal share of capacity.
+//
+// A hit must move its entry to the front of the list, which is a write, but
+// taking the exclusive lock on every hit would serialize readers. Hits
+// therefore look the entry up under the shared lock and only record the key
+// in the shard's read buffer (as Caffeine does). The buffer is replayed
+// onto the list by the next writer of the shard, or by the reader that
+// finds it full, if it can take the exclusive lock without waiting.
+// Otherwise the access is dropped: the list order is approximate under
+// heavy read load, and only for the most recent reads.
+template <typename Key, typename Value, typename Hash = concurrent::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class lru_cache {
+  using order_list = std::list<Key>; // Front is the most recently used
+
+  struct entry {
+    Value value;
+    typename order_list::iterator position;
+  };
+
+  using table_type = internal::map_backend_t<
+      Key, entry, Hash, KeyEqual, std::allocator<std::pair<const Key, entry>>>;
+
+  struct shard_state {
+    table_type entries;
+    order_list order;
+    size_t capacity = 0;
+  };
+
+  static constexpr size_t read_buffer_size = 64;
+
+  struct shard : internal::container_base<shard_state> {
+    mpmc_queue<Key> reads{read_buffer_size};
+  };
+
+  internal::sharded<shard> _shards;
+  size_t _capacity;
+  Hash _hasher;
+
+  shard &shard_for(const Key &key) { return _shards.for_hash(_hasher(key)); }
+  const shard &shard_for(const Key &key) const {
+    return const_cast<lru_cache *>(this)->shard_for(key);
+  }
+
+  // The helpers below need the shard's exclusive lock
+
+  static void promote(shard_state &state, const Key &key) {
+    auto it = state.entries.find(key);
+    if (it != state.entries.end())
+      state.order.splice(state.order.begin(), state.order,
+                         it->second.position);
+  }
+
+  // Replay the buffered reads onto the list, oldest first
+  static void drain(shard &s, shard_state &state) {
+    while (auto key = s.reads.try_pop())
+      promote(state, *key);
+  }
+
+  template <typename K, typename V> bool put_impl(K &&key, V &&value) {
+    shard &s = shard_for(key);
+    return s.execute_exclusive([&](shard_state &state) {
+      drain(s, state);
+      auto it = state.entries.find(key);
+      if (it != state.entries.end()) {
+        it->second.value = std::forward<V>(value);
+        state.order.splice(state.order.begin(), state.order,
+                           it->second.position);
+        return false;
+      }
+      state.order.push_front(key);
+      try {
+        state.entries.try_emplace(std::forward<K>(key),
+                                  entry{std::forward<V>(value),
+                                        state.order.begin()});
+      } catch (...) {
+        state.order.pop_front();
+        throw;
+      }
+      if (state.entries.size() > state.capacity) {
+        state.entries.erase(state.order.back());
+        state.order.pop_back();
+      }
+      return true;
+    });
+  }
+
+public:
+  /// At most capacity entries (at least one), spread over shards shards
+  /// (rounded up to a power of two, but no more than capacity; 0 picks a
+  /// count from the capacity and the core count). Each shard evicts on its
+  /// own once it holds its share of capacity.
+  explicit lru_cache(size_t capacity, size_t shards = 0,
+                     const Hash &hash = Hash())
+      : _shards(internal::cache_shard_count(capacity, shards)),
+        _capacity(capacity), _hasher(hash) {
+    for (size_t i = 0; i < _shards.size(); ++i) {
+      size_t share = internal::shard_capacity(capacity, _shards.size(), i);
+      _shards[i].execute_exclusive(
+          [&](shard_state &state) { state.capacity = share; });
+    }
+  }
+
+  lru_cache(const lru_cache &) = delete;
+  lru_cache &operator=(const lru_cache &) = delete;
+
+  /// Copy of the cached value, counted as a use of the entry. Takes only
+  /// the shard's shared lock.
+  std::optional<Value> get(const Key &key) {
+    shard &s = shard_for(key);
+    auto value = s.execute_shared(
+        [&](const shard_state &state) -> std::optional<Value> {
+          auto it = state.entries.find(key);
+          if (it == state.entries.end())
+            return std::nullopt;
+          return it->second.value;
+        });
+    if (value && !s.reads.try_emplace(key))
+      s.try_execute_exclusive([&](shard_state &state) {
+        drain(s, state);
+        promote(state, key);
+      });
+    return value;
+  }
+
+  /// Insert or replace the value of key and make it the most recently used
+  /// entry, evicting the shard's least recently used one if it is full.
+  /// Returns true if key was not cached before.
+  bool put(const Key &key, const Value &value) { return put_impl(key, value); }
+  bool put(Key &&key, Value &&value) {
+    return put_impl(std::move(key), std::move(value));
+  }
+
+  /// Lookup that does not count as a use
+  bool contains(const Key &key) const {
+    return shard_for(key).execute_shared([&](const shard_state &state) {
+      return state.entries.find(key) != state.entries.end();
+    });
+  }
+
+  size_t erase(const Key &key) {
+    return shard_for(key).execute_exclusive([&](shard_state &state) {
+      auto it = state.entries.find(key);
+      if (it == state.entries.end())
+        return size_t(0);
+      state.order.erase(it->second.position);
+      state.entries.erase(it);
+      return size_t(1);
+    });
+  }
+
+  void clear() {
+    _shards.for_each([](shard &s) {
+      s.execute_exclusive([&](shard_state &state) {
+        drain(s, state);
+        state.entries.clear();
+        state.order.clear();
+      });
+    });
+  }
+
+  size_t size() const {
+    size_t total = 0;
+    _shards.for_each([&](const shard &s) {
+      total += s.execute_shared(
+          [](const shard_state &state) { return state.entries.size(); });
+    });
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+  size_t capacity() const noexcept { return _capacity; }
+  size_t shard_count() const noexcept { return _shards.size(); }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_LRU_CACHE_H
@@ -0,0 +1,449 @@
+#ifndef CONCURRENT_MAP_H
+#define CONCURRENT_MAP_H
+
+#include "internal/epoch.h"
+#include "internal/platform.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+namespace internal {
+
+inline constexpr int skip_list_max_height = 20;
+
+// Height of a new node: each extra level with probability 1/4, which costs
+// 1.33 links per node on average and still indexes 4^20 keys well
+inline int random_skip_height() noexcept {
+  thread_local std::uint64_t state =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) |
+      0x9e3779b97f4a7c15ull;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  int height = 1;
+  for (std::uint64_t bits = state;
+       height < skip_list_max_height && (bits & 3) == 0; bits >>= 2)
+    ++height;
+  return height;
+}
+
+// Lock, flags and forward links shared by the head and the element nodes.
+// next points to height links allocated right behind the node.
+template <typename Node> struct skip_link {
+  std::atomic<Node *> *next = nullptr;
+  int height = 0;
+  std::atomic<bool> marked{false};       // Logically removed
+  std::atomic<bool> fully_linked{false}; // Linked at every level
+  spinlock lock;
+};
+
+template <typename Key, typename Value>
+struct skip_node : skip_link<skip_node<Key, Value>> {
+  const Key key;
+  Value value;
+
+  template <typename K, typename V>
+  skip_node(K &&k, V &&v) : key(std::forward<K>(k)), value(std::forward<V>(v)) {}
+
+  template <typename K, typename V>
+  static skip_node *create(int height, K &&k, V &&v) {
+    static_assert(alignof(skip_node) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "over-aligned keys and values are not supported");
+    using link_type = std::atomic<skip_node *>;
+    void *memory = ::operator new(sizeof(skip_node) + height * sizeof(link_type));
+    skip_node *n;
+    try {
+      n = ::new (memory) skip_node(std::forward<K>(k), std::forward<V>(v));
+    } catch (...) {
+      ::operator delete(memory);
+      throw;
+    }
+    auto *links = reinterpret_cast<link_type *>(static_cast<char *>(memory) +
+                                                sizeof(skip_node));
+    for (int i = 0; i < height; ++i)
+      ::new (&links[i]) link_type(nullptr);
+    n->next = links;
+    n->height = height;
+    return n;
+  }
+
+  static void destroy(void *p) {
+    static_cast<skip_node *>(p)->~skip_node();
+    ::operator delete(p);
+  }
+};
+
+} // namespace internal
+
+// Ordered map for concurrent use, built as a lazy skip list (Herlihy, Lev,
+// Luchangco and Shavit, "A Simple Optimistic Skiplist Algorithm").
+//
+// Lookups and scans take no lock on the structure: they walk the forward
+// links and only lock the one node whose value they copy. insert and erase
+// lock just the predecessors of the key at each level, so writers to
+// different parts of the key space do not contend. Removed nodes are freed
+// through an epoch_domain once no reader can still be on them.
+//
+// Range scans are weakly consistent: they see every element present for the
+// whole scan, in key order, and may or may not see concurrent changes.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class map {
+  using node = internal::skip_node<Key, Value>;
+  using link = internal::skip_link<node>;
+  static constexpr int max_height = internal::skip_list_max_height;
+
+  std::atomic<node *> _head_next[max_height];
+  mutable link _head;
+  Compare _less;
+  internal::epoch_domain *_domain;
+  std::atomic<size_t> _size{0};
+
+  // preds[l] is the last node (or the head) at level l with a key below key,
+  // succs[l] the node after it. Returns the highest level at which a node
+  // with key was found, or -1.
+  int find_position(const Key &key, link *preds[], node *succs[]) const {
+    int found = -1;
+    link *pred = &_head;
+    for (int level = max_height - 1; level >= 0; --level) {
+      node *curr = pred->next[level].load(std::memory_order_acquire);
+      while (curr && _less(curr->key, key)) {
+        pred = curr;
+        curr = pred->next[level].load(std::memory_order_acquire);
+      }
+      if (found == -1 && curr && !_less(key, curr->key))
+        found = level;
+      preds[level] = pred;
+      succs[level] = curr;
+    }
+    return found;
+  }
+
+  // First node at level 0 with a key not below key, present or not
+  node *seek(const Key &key) const {
+    link *pred = &_head;
+    node *curr = nullptr;
+    for (int level = max_height - 1; level >= 0; --level) {
+      curr = pred->next[level].load(std::memory_order_acquire);
+      while (curr && _less(curr->key, key)) {
+        pred = curr;
+        curr = pred->next[level].load(std::memory_order_acquire);
+      }
+    }
+    return curr;
+  }
+
+  static bool live(const node *n) {
+    return n->fully_linked.load(std::memory_order_acquire) &&
+           !n->marked.load(std::memory_order_acquire);
+  }
+
+  static node *next_node(const node *n) {
+    return n->next[0].load(std::memory_order_acquire);
+  }
+
+  // Lock the distinct predecessors of levels [0, height) bottom-up, i.e. in
+  // descending key order like every other lock path, and check they still
+  // point at succs. Returns the highest level locked for unlock_preds.
+  template <typename Check>
+  static int lock_preds(link *preds[], int height, Check &&still_valid,
+                        bool &valid) {
+    int highest = -1;
+    link *prev = nullptr;
+    valid = true;
+    for (int level = 0; valid && level < height; ++level) {
+      link *pred = preds[level];
+      if (pred != prev) {
+        pred->lock.lock();
+        highest = level;
+        prev = pred;
+      }
+      valid = !pred->marked.load(std::memory_order_relaxed) &&
+              still_valid(level);
+    }
+    return highest;
+  }
+
+  static void unlock_preds(link *preds[], int highest) {
+    link *prev = nullptr;
+    for (int level = 0; level <= highest; ++level) {
+      if (preds[level] != prev) {
+        preds[level]->lock.unlock();
+        prev = preds[level];
+      }
+    }
+  }
+
+  template <typename K, typename V> bool insert_impl(K &&key, V &&value,
+                                                     bool assign) {
+    auto guard = _domain->pin();
+    link *preds[max_height];
+    node *succs[max_height];
+    // Built on the first attempt that finds the key absent; from then on the
+    // key lives in the node, as K may have been moved from
+    node *fresh = nullptr;
+    const Key *search = &key;
+    internal::backoff wait;
+    for (;;) {
+      int found = find_position(*search, preds, succs);
+      if (found != -1) {
+        node *existing = succs[found];
+        if (!existing->marked.load(std::memory_order_acquire)) {
+          // Being inserted by another thread: it is about to be present
+          while (!existing->fully_linked.load(std::memory_order_acquire))
+            wait.pause();
+          if (assign) {
+            std::lock_guard<internal::spinlock> lock(existing->lock);
+            if (existing->marked.load(std::memory_order_relaxed))
+              continue;
+            if (fresh)
+              existing->value = std::move(fresh->value);
+            else
+              existing->value = std::forward<V>(value);
+          }
+          if (fresh)
+            node::destroy(fresh);
+          return false;
+        }
+        // Being removed: retry until it is unlinked
+        wait.pause();
+        continue;
+      }
+      if (!fresh) {
+        fresh = node::create(internal::random_skip_height(),
+                             std::forward<K>(key), std::forward<V>(value));
+        search = &fresh->key;
+      }
+      int height = fresh->height;
+      bool valid;
+      int highest = lock_preds(preds, height, [&](int level) {
+        node *succ = succs[level];
+        return (!succ || !succ->marked.load(std::memory_order_relaxed)) &&
+               preds[level]->next[level].load(std::memory_order_relaxed) ==
+                   succ;
+      }, valid);
+      if (!valid) {
+        unlock_preds(preds, highest);
+        wait.pause();
+        continue;
+      }
+      for (int level = 0; level < height; ++level)
+        fresh->next[level].store(succs[level], std::memory_order_relaxed);
+      for (int level = 0; level < height; ++level)
+        preds[level]->next[level].store(fresh, std::memory_order_release);
+      fresh->fully_linked.store(true, std::memory_order_release);
+      unlock_preds(preds, highest);
+      _size.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+public:
+  /// Removed nodes are retired to domain, the process-wide epoch domain by
+  /// default
+  explicit map(const Compare &comp = Compare(),
+               internal::epoch_domain &domain =
+                   internal::epoch_domain::global())
+      : _less(comp), _domain(&domain) {
+    for (auto &next : _head_next)
+      next.store(nullptr, std::memory_order_relaxed);
+    _head.next = _head_next;
+    _head.height = max_height;
+    _head.fully_linked.store(true, std::memory_order_relaxed);
+  }
+
+  map(const map &) = delete;
+  map &operator=(const map &) = delete;
+
+  /// No thread may be using the map. Nodes already retired are freed by the
+  /// epoch domain.
+  ~map() {
+    node *n = _head_next[0].load(std::memory_order_relaxed);
+    while (n) {
+      node *next = n->next[0].load(std::memory_order_relaxed);
+      node::destroy(n);
+      n = next;
+    }
+  }
+
+  /// Returns false, leaving the map unchanged, if key is already present
+  template <typename V> bool insert(const Key &key, V &&value) {
+    return insert_impl(key, std::forward<V>(value), false);
+  }
+
+  template <typename V> bool insert(Key &&key, V &&value) {
+    return insert_impl(std::move(key), std::forward<V>(value), false);
+  }
+
+  /// Returns true if key was inserted, false if its value was replaced
+  template <typename V> bool insert_or_assign(const Key &key, V &&value) {
+    return insert_impl(key, std::forward<V>(value), true);
+  }
+
+  template <typename V> bool insert_or_assign(Key &&key, V &&value) {
+    return insert_impl(std::move(key), std::forward<V>(value), true);
+  }
+
+  size_t erase(const Key &key) {
+    auto guard = _domain->pin();
+    link *preds[max_height];
+    node *succs[max_height];
+    node *victim = nullptr;
+    internal::backoff wait;
+    for (;;) {
+      int found = find_position(key, preds, succs);
+      if (!victim) {
+        if (found == -1)
+          return 0;
+        node *candidate = succs[found];
+        // Only a fully linked node found at its top level is safe to unlink
+        if (!candidate->fully_linked.load(std::memory_order_acquire) ||
+            candidate->height - 1 != found ||
+            candidate->marked.load(std::memory_order_acquire))
+          return 0;
+        candidate->lock.lock();
+        if (candidate->marked.load(std::memory_order_relaxed)) {
+          candidate->lock.unlock();
+          return 0;
+        }
+        candidate->marked.store(true, std::memory_order_release);
+        victim = candidate;
+      }
+      // The victim is ours now; unlink it once its predecessors are stable
+      int height = victim->height;
+      bool valid;
+      int highest = lock_preds(preds, height, [&](int level) {
+        return preds[level]->next[level].load(std::memory_order_relaxed) ==
+               victim;
+      }, valid);
+      if (!valid) {
+        unlock_preds(preds, highest);
+        wait.pause();
+        continue;
+      }
+      for (int level = height - 1; level >= 0; --level)
+        preds[level]->next[level].store(
+            victim->next[level].load(std::memory_order_relaxed),
+            std::memory_order_release);
+      victim->lock.unlock();
+      unlock_preds(preds, highest);
+      _size.fetch_sub(1, std::memory_order_relaxed);
+      _domain->retire(victim, &node::destroy);
+      return 1;
+    }
+  }
+
+  std::optional<Value> find(const Key &key) const {
+    auto guard = _domain->pin();
+    node *n = seek(key);
+    if (!n || _less(key, n->key) || !live(n))
+      return std::nullopt;
+    std::lock_guard<internal::spinlock> lock(n->lock);
+    if (n->marked.load(std::memory_order_relaxed))
+      return std::nullopt;
+    return n->value;
+  }
+
+  bool contains(const Key &key) const {
+    auto guard = _domain->pin();
+    node *n = seek(key);
+    return n && !_less(key, n->key) && live(n);
+  }
+
+  /// First element with a key not below key
+  std::optional<std::pair<Key, Value>> lower_bound(const Key &key) const {
+    auto guard = _domain->pin();
+    for (node *n = seek(key); n; n = next_node(n)) {
+      if (!live(n))
+        continue;
+      std::lock_guard<internal::spinlock> lock(n->lock);
+      if (!n->marked.load(std::memory_order_relaxed))
+        return std::make_pair(n->key, n->value);
+    }
+    return std::nullopt;
+  }
+
+  /// Call f(key, value) for the elements with keys in [first, last), in key
+  /// order. f runs with that element's node locked and must not call back
+  /// into the map. The scan keeps the epoch domain pinned, which holds back
+  /// reclamation; split very long scans into several ranges.
+  template <typename F>
+  void for_each_range(const Key &first, const Key &last, F &&f) const {
+    auto guard = _domain->pin();
+    for (node *n = seek(first); n && _less(n->key, last); n = next_node(n)) {
+      if (!live(n))
+        continue;
+      std::lock_guard<internal::spinlock> lock(n->lock);
+      if (!n->marked.load(std::memory_order_relaxed))
+        f(n->key, static_cast<const Value &>(n->value));
+    }
+  }
+
+  /// Same over the whole map
+  template <typename F> void for_each(F &&f) const {
+    auto guard = _domain->pin();
+    for (node *n = _head_next[0].load(std::memory_order_acquire); n;
+         n = next_node(n)) {
+      if (!live(n))
+        continue;
+      std::lock_guard<internal::spinlock> lock(n->lock);
+      if (!n->marked.load(std::memory_order_relaxed))
+        f(n->key, static_cast<const Value &>(n->value));
+    }
+  }
+
+  /// Copy of the elements with keys in [first, last)
+  std::vector<std::pair<Key, Value>> range(const Key &first,
+                                           const Key &last) const {
+    std::vector<std::pair<Key, Value>> data;
+    for_each_range(first, last, [&](const Key &key, const Value &value) {
+      data.emplace_back(key, value);
+    });
+    return data;
+  }
+
+  std::vector<std::pair<Key, Value>> snapshot() const {
+    std::vector<std::pair<Key, Value>> data;
+    data.reserve(size());
+    for_each([&](const Key &key, const Value &value) {
+      data.emplace_back(key, value);
+    });
+    return data;
+  }
+
+  /// Erases the elements one by one; not atomic with respect to inserts
+  void clear() {
+    for (;;) {
+      std::optional<Key> first;
+      {
+        auto guard = _domain->pin();
+        for (node *n = _head_next[0].load(std::memory_order_acquire); n;
+             n = next_node(n)) {
+          if (live(n)) {
+            first = n->key;
+            break;
+          }
+        }
+      }
+      if (!first)
+        return;
+      erase(*first);
+    }
+  }
+
+  /// Exact when no insert or erase is in progress
+  size_t size() const { return _size.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_MAP_H
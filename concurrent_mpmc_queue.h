@@ -0,0 +1,289 @@
+#ifndef CONCURRENT_MPMC_QUEUE_H
+#define CONCURRENT_MPMC_QUEUE_H
+
+#include "internal/platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+/// Bounded multi-producer multi-consumer FIFO queue (Dmitry Vyukov's
+/// design). A power-of-two ring of cells, each with a sequence number that
+/// tells producers and consumers whose turn the cell is; claiming a cell is a
+/// single CAS on the head or tail counter, and no operation ever waits for
+/// another thread to finish one already in progress elsewhere in the ring.
+///
+/// try_* operations never block. push() and pop() retry with backoff (spin,
+/// then yield) until they succeed, so they suit queues that are rarely full
+/// or empty for long.
+///
+/// A claimed cell must be published, or every consumer behind it waits
+/// forever. So nothing that can throw runs between the two: T must be
+/// nothrow move constructible, and an element whose construction may throw
+/// (a copy of a std::string, say) is built before its cell is claimed and
+/// moved in afterwards. If that constructor throws, nothing is pushed by
+/// the failing call, except for the earlier batches of a long try_push_n().
+template <typename T> class mpmc_queue {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "mpmc_queue moves elements in and out of its cells");
+
+  struct cell {
+    std::atomic<size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *value() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+  };
+
+  std::unique_ptr<cell[]> _cells;
+  size_t _mask;
+  // Producers and consumers each hammer their own counter
+  alignas(internal::cache_line_size) std::atomic<size_t> _tail{0};
+  alignas(internal::cache_line_size) std::atomic<size_t> _head{0};
+
+  static size_t round_capacity(size_t capacity) {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    return n;
+  }
+
+  // Claim up to count consecutive cells at _tail that are free in this lap.
+  // Returns the first position and how many were claimed.
+  std::pair<size_t, size_t> claim_push(size_t count) noexcept {
+    size_t pos = _tail.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t ready = 0;
+      while (ready < count) {
+        size_t seq = _cells[(pos + ready) & _mask].sequence.load(
+            std::memory_order_acquire);
+        if (seq != pos + ready)
+          break;
+        ++ready;
+      }
+      if (ready == 0) {
+        size_t seq = _cells[pos & _mask].sequence.load(std::memory_order_acquire);
+        // Behind by a lap: the queue is full
+        if (static_cast<std::ptrdiff_t>(seq - pos) < 0)
+          return {pos, 0};
+        pos = _tail.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (_tail.compare_exchange_weak(pos, pos + ready,
+                                      std::memory_order_relaxed))
+        return {pos, ready};
+    }
+  }
+
+  // Same for consumers: cells whose value for this lap has been published
+  std::pair<size_t, size_t> claim_pop(size_t count) noexcept {
+    size_t pos = _head.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t ready = 0;
+      while (ready < count) {
+        size_t seq = _cells[(pos + ready) & _mask].sequence.load(
+            std::memory_order_acquire);
+        if (seq != pos + ready + 1)
+          break;
+        ++ready;
+      }
+      if (ready == 0) {
+        size_t seq = _cells[pos & _mask].sequence.load(std::memory_order_acquire);
+        // Producer of this lap has not published yet: the queue is empty
+        if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0)
+          return {pos, 0};
+        pos = _head.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (_head.compare_exchange_weak(pos, pos + ready,
+                                      std::memory_order_relaxed))
+        return {pos, ready};
+    }
+  }
+
+  template <typename... Args>
+  static constexpr bool nothrow_emplace =
+      std::is_nothrow_constructible_v<T, Args &&...>;
+
+  // Fill a claimed cell; cannot fail, see above
+  template <typename... Args>
+  void publish(size_t pos, Args &&...args) noexcept {
+    static_assert(nothrow_emplace<Args...>);
+    cell &c = _cells[pos & _mask];
+    ::new (c.storage) T(std::forward<Args>(args)...);
+    c.sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  T consume(size_t pos) noexcept {
+    cell &c = _cells[pos & _mask];
+    T value(std::move(*c.value()));
+    c.value()->~T();
+    c.sequence.store(pos + _mask + 1, std::memory_order_release);
+    return value;
+  }
+
+public:
+  /// capacity is rounded up to a power of two (at least 2)
+  explicit mpmc_queue(size_t capacity)
+      : _cells(new cell[round_capacity(capacity)]),
+        _mask(round_capacity(capacity) - 1) {
+    for (size_t i = 0; i <= _mask; ++i)
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  mpmc_queue(const mpmc_queue &) = delete;
+  mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+  /// No thread may be using the queue; remaining elements are destroyed
+  ~mpmc_queue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      size_t tail = _tail.load(std::memory_order_relaxed);
+      for (size_t pos = _head.load(std::memory_order_relaxed); pos != tail;
+           ++pos)
+        _cells[pos & _mask].value()->~T();
+    }
+  }
+
+  size_t capacity() const noexcept { return _mask + 1; }
+
+  /// Elements in the queue; only a hint while other threads are using it
+  size_t size_approx() const noexcept {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+  bool empty_approx() const noexcept { return size_approx() == 0; }
+
+  /// When constructing T from args may throw, the element is built first,
+  /// and dropped again if the queue turns out to be full
+  template <typename... Args> bool try_emplace(Args &&...args) {
+    if constexpr (nothrow_emplace<Args...>) {
+      auto [pos, claimed] = claim_push(1);
+      if (!claimed)
+        return false;
+      publish(pos, std::forward<Args>(args)...);
+      return true;
+    } else {
+      T value(std::forward<Args>(args)...);
+      return try_emplace(std::move(value));
+    }
+  }
+
+  bool try_push(const T &value) { return try_emplace(value); }
+  bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+  bool try_pop(T &out) {
+    auto [pos, claimed] = claim_pop(1);
+    if (!claimed)
+      return false;
+    out = consume(pos);
+    return true;
+  }
+
+  std::optional<T> try_pop() {
+    auto [pos, claimed] = claim_pop(1);
+    if (!claimed)
+      return std::nullopt;
+    return consume(pos);
+  }
+
+  /// Push up to count elements copied from first, claiming their cells with
+  /// a single CAS. Returns how many were pushed (fewer if the queue fills).
+  /// Wrap the iterator in std::make_move_iterator to move them instead.
+  /// If copies may throw, they are made into a buffer of up to capacity()
+  /// elements before any cell is claimed, then moved in. A throwing copy
+  /// drops its own batch; batches pushed before it stay in the queue.
+  template <typename InputIt> size_t try_push_n(InputIt first, size_t count) {
+    size_t pushed = 0;
+    if constexpr (nothrow_emplace<decltype(*first)>) {
+      while (pushed < count) {
+        auto [pos, claimed] = claim_push(count - pushed);
+        if (!claimed)
+          break;
+        for (size_t i = 0; i < claimed; ++i, ++first)
+          publish(pos + i, *first);
+        pushed += claimed;
+      }
+    } else {
+      std::vector<T> staged;
+      while (pushed < count) {
+        staged.clear();
+        size_t batch = std::min(count - pushed, capacity());
+        for (size_t i = 0; i < batch; ++i, ++first)
+          staged.emplace_back(*first);
+        size_t moved =
+            try_push_n(std::make_move_iterator(staged.begin()), batch);
+        pushed += moved;
+        if (moved < batch)
+          break;
+      }
+    }
+    return pushed;
+  }
+
+  /// Pop up to max elements into out, claiming their cells with a single
+  /// CAS. Returns how many were popped. If writing to out throws, the rest
+  /// of the claimed cells are still released, and their elements destroyed.
+  template <typename OutputIt> size_t try_pop_n(OutputIt out, size_t max) {
+    size_t popped = 0;
+    while (popped < max) {
+      auto [pos, claimed] = claim_pop(max - popped);
+      if (!claimed)
+        break;
+      size_t i = 0;
+      try {
+        for (; i < claimed; ++i)
+          *out++ = consume(pos + i);
+      } catch (...) {
+        // consume() runs before the write, so cell i is already free
+        while (++i < claimed)
+          consume(pos + i);
+        throw;
+      }
+      popped += claimed;
+    }
+    return popped;
+  }
+
+  /// Blocking variants: retry with backoff until there is room / an element
+  template <typename... Args> void emplace(Args &&...args) {
+    if constexpr (nothrow_emplace<Args...>) {
+      internal::backoff wait;
+      for (;;) {
+        auto [pos, claimed] = claim_push(1);
+        if (claimed) {
+          publish(pos, std::forward<Args>(args)...);
+          return;
+        }
+        wait.pause();
+      }
+    } else {
+      T value(std::forward<Args>(args)...);
+      emplace(std::move(value));
+    }
+  }
+
+  void push(const T &value) { emplace(value); }
+  void push(T &&value) { emplace(std::move(value)); }
+
+  T pop() {
+    internal::backoff wait;
+    for (;;) {
+      auto [pos, claimed] = claim_pop(1);
+      if (claimed)
+        return consume(pos);
+      wait.pause();
+    }
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_MPMC_QUEUE_H
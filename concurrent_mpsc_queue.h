@@ -0,0 +1,210 @@
+#ifndef CONCURRENT_MPSC_QUEUE_H
+#define CONCURRENT_MPSC_QUEUE_H
+
+#include "internal/platform.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace concurrent {
+
+/// Link embedded in elements of an intrusive_mpsc_queue. Derive from it.
+/// Copying a node does not copy its place in a queue.
+class mpsc_hook {
+  template <typename> friend class intrusive_mpsc_queue;
+  std::atomic<mpsc_hook *> _mpsc_next{nullptr};
+
+public:
+  mpsc_hook() noexcept = default;
+  mpsc_hook(const mpsc_hook &) noexcept {}
+  mpsc_hook &operator=(const mpsc_hook &) noexcept { return *this; }
+};
+
+/// Unbounded multi-producer single-consumer queue of caller-owned nodes
+/// (Dmitry Vyukov's intrusive design). Node must derive from mpsc_hook.
+///
+/// push() is wait-free: one atomic exchange on the tail, then a store to link
+/// the previous node. It never allocates and never waits for other threads.
+/// Only one thread at a time may call pop() or drain(). A node stays owned by
+/// the caller; it must outlive its time in the queue and may be pushed again
+/// once popped.
+///
+/// A producer preempted between its exchange and its link hides the nodes
+/// pushed after it until it resumes, so pop() can briefly report empty while
+/// the queue is not.
+template <typename Node> class intrusive_mpsc_queue {
+  static_assert(std::is_base_of_v<mpsc_hook, Node>,
+                "intrusive_mpsc_queue nodes must derive from mpsc_hook");
+
+  // Producers only touch _tail; the consumer owns _head
+  alignas(internal::cache_line_size) std::atomic<mpsc_hook *> _tail;
+  alignas(internal::cache_line_size) mpsc_hook *_head;
+  // Placeholder that keeps the list non-empty, so producers never touch
+  // _head
+  mpsc_hook _stub;
+
+  void link(mpsc_hook *hook) noexcept {
+    hook->_mpsc_next.store(nullptr, std::memory_order_relaxed);
+    mpsc_hook *prev = _tail.exchange(hook, std::memory_order_acq_rel);
+    prev->_mpsc_next.store(hook, std::memory_order_release);
+  }
+
+public:
+  intrusive_mpsc_queue() noexcept : _tail(&_stub), _head(&_stub) {}
+
+  intrusive_mpsc_queue(const intrusive_mpsc_queue &) = delete;
+  intrusive_mpsc_queue &operator=(const intrusive_mpsc_queue &) = delete;
+
+  void push(Node *node) noexcept { link(node); }
+
+  /// Oldest node, or nullptr if none is visible yet. Consumer only.
+  Node *pop() noexcept {
+    mpsc_hook *head = _head;
+    mpsc_hook *next = head->_mpsc_next.load(std::memory_order_acquire);
+    if (head == &_stub) {
+      if (!next)
+        return nullptr;
+      _head = head = next;
+      next = next->_mpsc_next.load(std::memory_order_acquire);
+    }
+    if (next) {
+      _head = next;
+      return static_cast<Node *>(head);
+    }
+    // head is the last linked node. If a producer has already swung the tail
+    // past it, its link is on the way.
+    if (head != _tail.load(std::memory_order_acquire))
+      return nullptr;
+    // Put the stub back behind head so head can be handed out
+    link(&_stub);
+    next = head->_mpsc_next.load(std::memory_order_acquire);
+    if (next) {
+      _head = next;
+      return static_cast<Node *>(head);
+    }
+    return nullptr;
+  }
+
+  /// Pop up to max nodes and pass each to f, oldest first. Returns how many
+  /// were popped. Consumer only.
+  template <typename F>
+  size_t drain(F &&f, size_t max = static_cast<size_t>(-1)) {
+    size_t drained = 0;
+    while (drained < max) {
+      Node *node = pop();
+      if (!node)
+        break;
+      f(node);
+      ++drained;
+    }
+    return drained;
+  }
+
+  /// Only exact when called by the consumer with no push() in progress.
+  /// _head is the next node to hand out unless it is the stub.
+  bool empty_approx() const noexcept {
+    return _head == &_stub && !_stub._mpsc_next.load(std::memory_order_acquire);
+  }
+};
+
+/// Unbounded multi-producer single-consumer queue of values, for mailboxes
+/// and log shipping: many threads push, one thread drains. Built on
+/// intrusive_mpsc_queue with one allocated node per element, so producers
+/// only contend inside the allocator (pass concurrent::pool_allocator to
+/// serve the nodes from per-thread caches).
+template <typename T, typename Allocator = std::allocator<T>> class mpsc_queue {
+  struct node : mpsc_hook {
+    T value;
+
+    template <typename... Args>
+    explicit node(Args &&...args) : value(std::forward<Args>(args)...) {}
+  };
+
+  using node_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  intrusive_mpsc_queue<node> _queue;
+  node_allocator _alloc;
+
+  void release(node *n) {
+    node_traits::destroy(_alloc, n);
+    node_traits::deallocate(_alloc, n, 1);
+  }
+
+public:
+  mpsc_queue() = default;
+  explicit mpsc_queue(const Allocator &alloc) : _alloc(alloc) {}
+
+  mpsc_queue(const mpsc_queue &) = delete;
+  mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+  /// No thread may be using the queue; remaining elements are destroyed
+  ~mpsc_queue() {
+    while (node *n = _queue.pop())
+      release(n);
+  }
+
+  /// Producer side: any number of threads
+  template <typename... Args> void emplace(Args &&...args) {
+    node *n = node_traits::allocate(_alloc, 1);
+    try {
+      node_traits::construct(_alloc, n, std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits::deallocate(_alloc, n, 1);
+      throw;
+    }
+    _queue.push(n);
+  }
+
+  void push(const T &value) { emplace(value); }
+  void push(T &&value) { emplace(std::move(value)); }
+
+  /// Consumer side: one thread at a time
+  std::optional<T> try_pop() {
+    node *n = _queue.pop();
+    if (!n)
+      return std::nullopt;
+    std::optional<T> value(std::move(n->value));
+    release(n);
+    return value;
+  }
+
+  bool try_pop(T &out) {
+    node *n = _queue.pop();
+    if (!n)
+      return false;
+    out = std::move(n->value);
+    release(n);
+    return true;
+  }
+
+  /// Pass up to max elements to f as T&&, oldest first, and return how many
+  /// were drained. One call empties a backlog without a round trip per
+  /// element, e.g. to write a whole batch of log records at once.
+  template <typename F>
+  size_t drain(F &&f, size_t max = static_cast<size_t>(-1)) {
+    return _queue.drain(
+        [&](node *n) {
+          std::unique_ptr<node, release_deleter> guard(n, release_deleter{this});
+          f(std::move(n->value));
+        },
+        max);
+  }
+
+  bool empty_approx() const noexcept { return _queue.empty_approx(); }
+
+private:
+  // Frees a drained node even if f throws
+  struct release_deleter {
+    mpsc_queue *queue;
+    void operator()(node *n) const { queue->release(n); }
+  };
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_MPSC_QUEUE_H
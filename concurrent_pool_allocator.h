@@ -0,0 +1,67 @@
+#ifndef CONCURRENT_POOL_ALLOCATOR_H
+#define CONCURRENT_POOL_ALLOCATOR_H
+
+#include "internal/node_pool.h"
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace concurrent {
+
+// Stateless allocator serving small blocks from size-class pools with
+// per-thread free lists backed by shared slabs. Node-based containers
+// allocate one node at a time, which is exactly what the pools are sized
+// for; bigger or over-aligned requests fall back to operator new.
+//
+//   concurrent::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+//       concurrent::pool_allocator<std::pair<const int, int>>> map;
+template <typename T> class pool_allocator {
+  static constexpr bool pooled(std::size_t bytes) noexcept {
+    return bytes <= internal::pool_max_block &&
+           alignof(T) <= internal::pool_granularity;
+  }
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  pool_allocator() noexcept = default;
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U> &) noexcept {}
+
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    const std::size_t bytes = n * sizeof(T);
+    if (pooled(bytes))
+      return static_cast<T *>(internal::pool_allocate(bytes));
+    return static_cast<T *>(::operator new(bytes));
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    const std::size_t bytes = n * sizeof(T);
+    if (pooled(bytes))
+      internal::pool_deallocate(p, bytes);
+    else
+      ::operator delete(p);
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const pool_allocator<T> &, const pool_allocator<U> &) noexcept {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const pool_allocator<T> &, const pool_allocator<U> &) noexcept {
+  return false;
+}
+
+} // namespace concurrent
+
+#endif // CONCURRENT_POOL_ALLOCATOR_H
@@ -0,0 +1,221 @@
+#ifndef CONCURRENT_PRIORITY_QUEUE_H
+#define CONCURRENT_PRIORITY_QUEUE_H
+
+#include "internal/platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+enum class priority_order {
+  strict, // Every pop returns the current top
+  relaxed // Pops return one of the top elements; scales with threads
+};
+
+// Priority queue for schedulers and timer wheels. Like std::priority_queue,
+// the top is the greatest element under Compare: use std::greater for
+// earliest-deadline-first.
+//
+// Strict mode is a single binary heap behind a spinlock. The batch
+// operations (push of a range, pop_n) amortize the lock over many elements.
+//
+// Relaxed mode is a MultiQueue (Rihani, Sanders and Dementiev): several
+// heaps, each behind its own lock. push() goes to a random heap; pop()
+// looks at two random heaps and takes the better top. Pops are not exactly
+// in order, but the rank error stays small (on the order of the number of
+// heaps) while pushes and pops from many threads rarely meet on a lock.
+template <typename T, typename Compare = std::less<T>> class priority_queue {
+  struct alignas(internal::cache_line_size) heap {
+    internal::spinlock lock;
+    std::atomic<size_t> size{0}; // Readable without the lock
+    std::vector<T> items;
+  };
+
+  std::unique_ptr<heap[]> _heaps;
+  size_t _count;
+  priority_order _order;
+  Compare _less;
+
+  auto heap_less() const {
+    return [this](const T &a, const T &b) { return _less(a, b); };
+  }
+
+  static std::uint64_t random() noexcept {
+    thread_local std::uint64_t state =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) |
+        0x9e3779b97f4a7c15ull;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+
+  // Lock and return the heap to push to
+  heap &lock_push_target() {
+    // Skip locked heaps instead of waiting for them, for a while
+    for (size_t attempt = 1; attempt < _count; ++attempt) {
+      heap &h = _heaps[random() % _count];
+      if (h.lock.try_lock())
+        return h;
+    }
+    heap &h = _heaps[_count == 1 ? 0 : random() % _count];
+    h.lock.lock();
+    return h;
+  }
+
+  template <typename... Args> void emplace_locked(heap &h, Args &&...args) {
+    h.items.emplace_back(std::forward<Args>(args)...);
+    std::push_heap(h.items.begin(), h.items.end(), heap_less());
+    h.size.store(h.items.size(), std::memory_order_relaxed);
+  }
+
+  T take_locked(heap &h) {
+    std::pop_heap(h.items.begin(), h.items.end(), heap_less());
+    T value = std::move(h.items.back());
+    h.items.pop_back();
+    h.size.store(h.items.size(), std::memory_order_relaxed);
+    return value;
+  }
+
+  // Lock and return the heap to pop from, or null if all looked empty
+  heap *lock_pop_source() {
+    if (_count == 1) {
+      _heaps[0].lock.lock();
+      if (!_heaps[0].items.empty())
+        return &_heaps[0];
+      _heaps[0].lock.unlock();
+      return nullptr;
+    }
+    // Two random choices, locked in index order
+    size_t i = random() % _count, j = random() % _count;
+    if (i > j)
+      std::swap(i, j);
+    heap &a = _heaps[i], &b = _heaps[j];
+    a.lock.lock();
+    if (i != j)
+      b.lock.lock();
+    heap *best = nullptr;
+    if (!a.items.empty())
+      best = &a;
+    if (i != j && !b.items.empty() &&
+        (!best || _less(a.items.front(), b.items.front())))
+      best = &b;
+    if (best != &a)
+      a.lock.unlock();
+    if (i != j && best != &b)
+      b.lock.unlock();
+    if (best)
+      return best;
+    // Both empty: sweep all heaps before reporting the queue empty
+    size_t start = random() % _count;
+    for (size_t k = 0; k < _count; ++k) {
+      heap &h = _heaps[(start + k) % _count];
+      if (h.size.load(std::memory_order_relaxed) == 0)
+        continue;
+      h.lock.lock();
+      if (!h.items.empty())
+        return &h;
+      h.lock.unlock();
+    }
+    return nullptr;
+  }
+
+public:
+  /// heaps is the number of heaps in relaxed mode; 0 picks four per
+  /// hardware thread. Strict mode always uses one.
+  explicit priority_queue(priority_order order = priority_order::strict,
+                          size_t heaps = 0, const Compare &comp = Compare())
+      : _order(order), _less(comp) {
+    if (order == priority_order::strict) {
+      heaps = 1;
+    } else if (heaps == 0) {
+      size_t threads = std::thread::hardware_concurrency();
+      heaps = 4 * (threads ? threads : 1);
+    }
+    _count = heaps;
+    _heaps.reset(new heap[_count]);
+  }
+
+  priority_queue(const priority_queue &) = delete;
+  priority_queue &operator=(const priority_queue &) = delete;
+
+  priority_order order() const noexcept { return _order; }
+
+  template <typename... Args> void emplace(Args &&...args) {
+    heap &h = lock_push_target();
+    std::lock_guard<internal::spinlock> lock(h.lock, std::adopt_lock);
+    emplace_locked(h, std::forward<Args>(args)...);
+  }
+
+  void push(const T &value) { emplace(value); }
+  void push(T &&value) { emplace(std::move(value)); }
+
+  /// Push [first, last) under one lock (into one heap in relaxed mode)
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void push(InputIt first, InputIt last) {
+    heap &h = lock_push_target();
+    std::lock_guard<internal::spinlock> lock(h.lock, std::adopt_lock);
+    for (; first != last; ++first)
+      emplace_locked(h, *first);
+  }
+
+  /// Take the top element (one of the top ones in relaxed mode). Returns
+  /// false only if every heap was found empty.
+  bool try_pop(T &out) {
+    heap *h = lock_pop_source();
+    if (!h)
+      return false;
+    std::lock_guard<internal::spinlock> lock(h->lock, std::adopt_lock);
+    out = take_locked(*h);
+    return true;
+  }
+
+  std::optional<T> try_pop() {
+    heap *h = lock_pop_source();
+    if (!h)
+      return std::nullopt;
+    std::lock_guard<internal::spinlock> lock(h->lock, std::adopt_lock);
+    return take_locked(*h);
+  }
+
+  /// Pop up to max elements in priority order under one lock and write them
+  /// to out. In relaxed mode they all come from the one heap that try_pop()
+  /// would pick. Returns how many were popped.
+  template <typename OutputIt> size_t pop_n(OutputIt out, size_t max) {
+    if (max == 0)
+      return 0;
+    heap *h = lock_pop_source();
+    if (!h)
+      return 0;
+    std::lock_guard<internal::spinlock> lock(h->lock, std::adopt_lock);
+    size_t popped = 0;
+    for (; popped < max && !h->items.empty(); ++popped)
+      *out++ = take_locked(*h);
+    return popped;
+  }
+
+  /// Only a hint while other threads are using the queue
+  size_t size_approx() const noexcept {
+    size_t total = 0;
+    for (size_t i = 0; i < _count; ++i)
+      total += _heaps[i].size.load(std::memory_order_relaxed);
+    return total;
+  }
+
+  bool empty_approx() const noexcept { return size_approx() == 0; }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_PRIORITY_QUEUE_H
@@ -0,0 +1,222 @@
+#ifndef CONCURRENT_SPSC_QUEUE_H
+#define CONCURRENT_SPSC_QUEUE_H
+
+#include "internal/platform.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace concurrent {
+
+/// Bounded single-producer single-consumer FIFO queue for fixed
+/// thread-to-thread pipelines. Exactly one thread may push and exactly one
+/// thread may pop at a time.
+///
+/// Each side keeps a private copy of the other side's index and only reloads
+/// the shared one when the copy says the queue is full (producer) or empty
+/// (consumer). In steady state a push or pop touches no cache line written by
+/// the other thread except the slot itself. push_n() and pop_n() publish a
+/// whole batch with one index store.
+template <typename T> class spsc_queue {
+  struct storage {
+    alignas(T) unsigned char bytes[sizeof(T)];
+  };
+
+  std::unique_ptr<storage[]> _slots;
+  size_t _mask;
+
+  // Producer's line: its index and its copy of the consumer's
+  alignas(internal::cache_line_size) std::atomic<size_t> _tail{0};
+  size_t _head_cache = 0;
+  // Consumer's line
+  alignas(internal::cache_line_size) std::atomic<size_t> _head{0};
+  size_t _tail_cache = 0;
+
+  static size_t round_capacity(size_t capacity) {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    return n;
+  }
+
+  T *slot(size_t pos) noexcept {
+    return std::launder(reinterpret_cast<T *>(_slots[pos & _mask].bytes));
+  }
+
+  // Free slots the producer may fill from tail, reloading _head only when
+  // the cached copy has none left for it
+  size_t writable(size_t tail, size_t wanted) noexcept {
+    size_t free = capacity() - (tail - _head_cache);
+    if (free < wanted) {
+      _head_cache = _head.load(std::memory_order_acquire);
+      free = capacity() - (tail - _head_cache);
+    }
+    return free;
+  }
+
+  // Filled slots the consumer may take from head
+  size_t readable(size_t head, size_t wanted) noexcept {
+    size_t filled = _tail_cache - head;
+    if (filled < wanted) {
+      _tail_cache = _tail.load(std::memory_order_acquire);
+      filled = _tail_cache - head;
+    }
+    return filled;
+  }
+
+  // The slot is destroyed on return: _head must pass it before anything that
+  // can throw, or a later pop and the destructor would use it again
+  T take(size_t pos) {
+    T *p = slot(pos);
+    T value(std::move(*p));
+    p->~T();
+    return value;
+  }
+
+public:
+  /// capacity is rounded up to a power of two (at least 2)
+  explicit spsc_queue(size_t capacity)
+      : _slots(new storage[round_capacity(capacity)]),
+        _mask(round_capacity(capacity) - 1) {}
+
+  spsc_queue(const spsc_queue &) = delete;
+  spsc_queue &operator=(const spsc_queue &) = delete;
+
+  /// No thread may be using the queue; remaining elements are destroyed
+  ~spsc_queue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      size_t tail = _tail.load(std::memory_order_relaxed);
+      for (size_t pos = _head.load(std::memory_order_relaxed); pos != tail;
+           ++pos)
+        slot(pos)->~T();
+    }
+  }
+
+  size_t capacity() const noexcept { return _mask + 1; }
+
+  /// Exact from either end when the other thread is idle, otherwise a hint
+  size_t size_approx() const noexcept {
+    // head first: the tail read after it can only be further ahead
+    size_t head = _head.load(std::memory_order_acquire);
+    size_t tail = _tail.load(std::memory_order_acquire);
+    return tail - head;
+  }
+
+  bool empty_approx() const noexcept { return size_approx() == 0; }
+
+  // --- Producer side ---
+
+  template <typename... Args> bool try_emplace(Args &&...args) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (!writable(tail, 1))
+      return false;
+    ::new (slot(tail)) T(std::forward<Args>(args)...);
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T &value) { return try_emplace(value); }
+  bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+  /// Push up to count elements copied from first and make them visible to
+  /// the consumer at once. Returns how many were pushed (fewer if the queue
+  /// fills). Wrap the iterator in std::make_move_iterator to move them.
+  /// If a copy throws, the ones already made are destroyed and nothing is
+  /// pushed.
+  template <typename InputIt> size_t push_n(InputIt first, size_t count) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    size_t n = writable(tail, count);
+    if (n > count)
+      n = count;
+    size_t built = 0;
+    try {
+      for (; built < n; ++built, ++first)
+        ::new (slot(tail + built)) T(*first);
+    } catch (...) {
+      while (built)
+        slot(tail + --built)->~T();
+      throw;
+    }
+    if (n)
+      _tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  /// Blocking variants: retry with backoff until there is room
+  template <typename... Args> void emplace(Args &&...args) {
+    internal::backoff wait;
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    while (!writable(tail, 1))
+      wait.pause();
+    ::new (slot(tail)) T(std::forward<Args>(args)...);
+    _tail.store(tail + 1, std::memory_order_release);
+  }
+
+  void push(const T &value) { emplace(value); }
+  void push(T &&value) { emplace(std::move(value)); }
+
+  // --- Consumer side ---
+
+  bool try_pop(T &out) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (!readable(head, 1))
+      return false;
+    T value(take(head));
+    _head.store(head + 1, std::memory_order_release);
+    out = std::move(value);
+    return true;
+  }
+
+  std::optional<T> try_pop() {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (!readable(head, 1))
+      return std::nullopt;
+    T value(take(head));
+    _head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  /// Pop up to max elements into out and hand their slots back to the
+  /// producer at once. Returns how many were popped. If writing to out
+  /// throws, the element being written is lost and the rest stay queued.
+  template <typename OutputIt> size_t pop_n(OutputIt out, size_t max) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t n = readable(head, max);
+    if (n > max)
+      n = max;
+    size_t taken = 0;
+    try {
+      while (taken < n) {
+        T value(take(head + taken));
+        ++taken;
+        *out++ = std::move(value);
+      }
+    } catch (...) {
+      if (taken)
+        _head.store(head + taken, std::memory_order_release);
+      throw;
+    }
+    if (n)
+      _head.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  /// Blocking variant: retry with backoff until an element arrives
+  T pop() {
+    internal::backoff wait;
+    size_t head = _head.load(std::memory_order_relaxed);
+    while (!readable(head, 1))
+      wait.pause();
+    T value(take(head));
+    _head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_SPSC_QUEUE_H
@@ -0,0 +1,315 @@
+#ifndef CONCURRENT_THREAD_POOL_H
+#define CONCURRENT_THREAD_POOL_H
+
+#include "internal/platform.h"
+#include "internal/work_stealing_deque.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+// Small work-stealing thread pool, used by the library's own parallel
+// operations (unordered_map::parallel_for_each) and available to callers.
+//
+// Each worker owns a Chase-Lev deque. Tasks submitted from a worker go to the
+// bottom of its own deque and run LIFO; tasks submitted from other threads
+// go to a shared injection queue. An idle worker first drains its own deque,
+// then the injection queue, then steals from the top of other workers'
+// deques, and sleeps only when all of them are empty.
+//
+// A thread that waits for a parallel_for() runs, in the meantime, the pieces
+// of that loop nobody has started yet, and nothing else: it may hold a lock
+// (unordered_map::parallel_update holds its map's) that an unrelated task
+// needs. Since the waiter can always finish its own loop, nested parallel
+// loops cannot deadlock the pool either.
+class thread_pool {
+  struct task {
+    virtual ~task() = default;
+    virtual void run() = 0;
+  };
+
+  template <typename F> struct task_impl final : task {
+    F func;
+    explicit task_impl(F f) : func(std::move(f)) {}
+    void run() override { func(); }
+  };
+
+  struct worker {
+    thread_pool *pool;
+    size_t index;
+    internal::work_stealing_deque<task *> deque;
+    std::thread thread;
+  };
+
+  // Upper half of a parallel_for() range split off for other threads. It is
+  // queued in the pool and listed in its loop_state; whoever claims it first
+  // runs it, and the other copy is dropped.
+  struct range {
+    size_t first;
+    size_t last;
+    std::atomic<bool> claimed{false};
+
+    range(size_t f, size_t l) : first(f), last(l) {}
+    bool claim() noexcept {
+      return !claimed.exchange(true, std::memory_order_acq_rel);
+    }
+  };
+
+  // Shared state of one parallel_for() call
+  struct loop_state {
+    std::atomic<size_t> pending{1}; // Ranges not finished yet
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    std::mutex ranges_mutex;
+    std::vector<std::shared_ptr<range>> ranges; // Split off, maybe unclaimed
+
+    void fail() {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      failed.store(true, std::memory_order_relaxed);
+    }
+
+    void add(std::shared_ptr<range> r) {
+      std::lock_guard<std::mutex> lock(ranges_mutex);
+      ranges.push_back(std::move(r));
+    }
+
+    // Most recently split range that no other thread has claimed yet
+    std::shared_ptr<range> claim_range() {
+      std::lock_guard<std::mutex> lock(ranges_mutex);
+      while (!ranges.empty()) {
+        std::shared_ptr<range> r = std::move(ranges.back());
+        ranges.pop_back();
+        if (r->claim())
+          return r;
+      }
+      return nullptr;
+    }
+  };
+
+  std::vector<std::unique_ptr<worker>> _workers;
+  std::mutex _inject_mutex;
+  std::deque<task *> _injected;
+
+  // Tasks pushed and not taken yet; idle workers sleep while it is zero
+  std::atomic<size_t> _queued{0};
+  std::atomic<size_t> _sleepers{0};
+  std::atomic<bool> _stop{false};
+  std::mutex _sleep_mutex;
+  std::condition_variable _wake;
+
+  static worker *&current_worker() noexcept {
+    thread_local worker *current = nullptr;
+    return current;
+  }
+
+  worker *local_worker() const noexcept {
+    worker *w = current_worker();
+    return w && w->pool == this ? w : nullptr;
+  }
+
+  void enqueue(task *t) {
+    if (worker *w = local_worker()) {
+      w->deque.push(t);
+    } else {
+      std::lock_guard<std::mutex> lock(_inject_mutex);
+      _injected.push_back(t);
+    }
+    // Pairs with the sleeper check in worker_loop: either the worker sees
+    // the new count, or we see it registered and wake it under the mutex
+    _queued.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+      { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+      _wake.notify_one();
+    }
+  }
+
+  task *take_injected() {
+    std::lock_guard<std::mutex> lock(_inject_mutex);
+    if (_injected.empty())
+      return nullptr;
+    task *t = _injected.front();
+    _injected.pop_front();
+    return t;
+  }
+
+  task *find_task() {
+    task *t = nullptr;
+    worker *self = local_worker();
+    if (self && self->deque.pop(t))
+      return t;
+    if (_queued.load(std::memory_order_relaxed) == 0)
+      return nullptr;
+    if ((t = take_injected()))
+      return t;
+    // Start at a different victim per thread to spread the thieves
+    size_t n = _workers.size();
+    size_t start = self ? self->index + 1
+                        : std::hash<std::thread::id>()(
+                              std::this_thread::get_id());
+    for (size_t i = 0; i < n; ++i) {
+      worker &victim = *_workers[(start + i) % n];
+      if (&victim != self && victim.deque.steal(t))
+        return t;
+    }
+    return nullptr;
+  }
+
+  // Run one queued task on this thread; false if none was found
+  bool run_one() {
+    task *t = find_task();
+    if (!t)
+      return false;
+    _queued.fetch_sub(1, std::memory_order_relaxed);
+    std::unique_ptr<task> owned(t);
+    owned->run();
+    return true;
+  }
+
+  void worker_loop(worker *self) {
+    current_worker() = self;
+    internal::backoff wait;
+    for (;;) {
+      if (run_one()) {
+        wait.reset();
+        continue;
+      }
+      if (_stop.load(std::memory_order_acquire) &&
+          _queued.load(std::memory_order_acquire) == 0)
+        return;
+      // Spin and yield briefly before sleeping: tasks often come in bursts
+      if (_queued.load(std::memory_order_relaxed) > 0 || wait_spinning(wait))
+        continue;
+      std::unique_lock<std::mutex> lock(_sleep_mutex);
+      _sleepers.fetch_add(1, std::memory_order_seq_cst);
+      _wake.wait(lock, [this] {
+        return _queued.load(std::memory_order_seq_cst) > 0 ||
+               _stop.load(std::memory_order_acquire);
+      });
+      _sleepers.fetch_sub(1, std::memory_order_relaxed);
+      wait.reset();
+    }
+  }
+
+  // Pause once; true while the backoff has not reached its yielding phase
+  static bool wait_spinning(internal::backoff &wait) {
+    wait.pause();
+    return !wait.yielding();
+  }
+
+  template <typename F>
+  void run_range(loop_state &state, size_t first, size_t last, size_t grain,
+                 F &f) {
+    try {
+      // Hand the upper halves to thieves and keep splitting the lower one
+      while (last - first > grain &&
+             !state.failed.load(std::memory_order_relaxed)) {
+        size_t middle = first + (last - first) / 2;
+        auto upper = std::make_shared<range>(middle, last);
+        state.pending.fetch_add(1, std::memory_order_relaxed);
+        state.add(upper);
+        // state and f are only touched if the range is still unclaimed, in
+        // which case the loop cannot have finished
+        submit([this, &state, upper, grain, &f] {
+          if (upper->claim())
+            run_range(state, upper->first, upper->last, grain, f);
+        });
+        last = middle;
+      }
+      for (; first < last && !state.failed.load(std::memory_order_relaxed);
+           ++first)
+        f(first);
+    } catch (...) {
+      state.fail();
+    }
+    state.pending.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+public:
+  /// threads = 0 uses one worker per hardware thread
+  explicit thread_pool(size_t threads = 0) {
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+      threads = 1;
+    _workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      _workers.push_back(std::make_unique<worker>());
+      _workers.back()->pool = this;
+      _workers.back()->index = i;
+    }
+    for (auto &w : _workers)
+      w->thread = std::thread([this, p = w.get()] { worker_loop(p); });
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  /// Runs the tasks still queued, then joins the workers
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(_sleep_mutex);
+      _stop.store(true, std::memory_order_release);
+    }
+    _wake.notify_all();
+    for (auto &w : _workers)
+      w->thread.join();
+  }
+
+  /// Pool used by the library's parallel operations when none is passed,
+  /// with one worker per hardware thread, started on first use
+  static thread_pool &shared() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  size_t size() const noexcept { return _workers.size(); }
+
+  /// Run f() on some worker. An exception escaping f terminates the program;
+  /// use parallel_for() to get exceptions back.
+  template <typename F> void submit(F &&f) {
+    enqueue(new task_impl<std::decay_t<F>>(std::forward<F>(f)));
+  }
+
+  /// Call f(i) for every i in [first, last) in parallel and return when all
+  /// calls have finished. The range is split in halves down to grain
+  /// indices per task (0 picks about 8 tasks per worker). The calling thread
+  /// works on the loop too, and on nothing else. If a call throws, the
+  /// remaining indices are skipped and the first exception is rethrown here.
+  template <typename F>
+  void parallel_for(size_t first, size_t last, F &&f, size_t grain = 0) {
+    if (first >= last)
+      return;
+    if (grain == 0)
+      grain = (last - first) / (size() * 8) + 1;
+    loop_state state;
+    run_range(state, first, last, grain, f);
+    internal::backoff wait;
+    while (state.pending.load(std::memory_order_acquire) > 0) {
+      if (auto r = state.claim_range()) {
+        run_range(state, r->first, r->last, grain, f);
+        wait.reset();
+      } else {
+        wait.pause();
+      }
+    }
+    if (state.error)
+      std::rethrow_exception(state.error);
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_THREAD_POOL_H
@@ -1,9 +1,19 @@
 #ifndef CONCURRENT_UNORDERED_MAP_H
 #define CONCURRENT_UNORDERED_MAP_H
 
+#include "concurrent_hash.h"
 #include "internal/container_base.h"
+#include "internal/flood_guard.h"
+#include "internal/hash_diagnostics.h"
+#include "internal/map_backend.h"
+#include "internal/memory_usage.h"
+#include "internal/operation_stats.h"
+#include "internal/parallel_visit.h"
 #include <functional>
+#include <iterator>
+#include <memory_resource>
 #include <mutex>
+#include <new>
 #include <optional>
 #include <shared_mutex>
 #include <type_traits>
@@ -13,21 +23,40 @@
 
 namespace concurrent {
 
-// Implement a thread-safe unordered_map based on the base class
-template <typename Key, typename Value, typename Hash = std::hash<Key>,
+// Implement a thread-safe unordered_map based on the base class.
+// Container is the table behind it: std::unordered_map unless the map is
+// declared as a flat_unordered_map (below).
+template <typename Key, typename Value, typename Hash = concurrent::hash<Key>,
           typename KeyEqual = std::equal_to<Key>,
           typename Allocator = std::allocator<std::pair<const Key, Value>>,
-          typename MutexT = std::shared_mutex>
-class unordered_map
-    : public internal::container_base<
-          std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>, MutexT> {
-
-  using Base = internal::container_base<
-      std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>, MutexT>;
-  using internal_type =
-      std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>;
+          typename MutexT = std::shared_mutex,
+          typename Container =
+              std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>>
+class unordered_map : public internal::container_base<Container, MutexT> {
+public:
+  // What execute_shared() and execute_exclusive() hand out
+  using container_type = Container;
+
+private:
+  using Base = internal::container_base<container_type, MutexT>;
+  using internal_type = container_type;
   using pair_type = std::pair<const Key, Value>;
 
+  internal::flood_guard _flood_guard; // Guarded by the exclusive lock
+
+#ifdef CONCURRENT_STL_OP_STATS
+  mutable internal::operation_recorder _op_stats;
+
+  internal::operation_recorder::timer
+  time_operation(internal::operation op) const {
+    return internal::operation_recorder::timer(_op_stats, op);
+  }
+#else
+  internal::null_operation_timer time_operation(internal::operation) const {
+    return {};
+  }
+#endif
+
 public:
   // Forward constructor to base class
   template <typename... Args>
@@ -39,24 +68,56 @@ public:
   template <typename P, typename std::enable_if_t<
                             std::is_constructible_v<pair_type, P>, int> = 0>
   bool insert(P &&obj) {
+    auto timer = time_operation(internal::operation::insert);
     return this->execute_exclusive([&](internal_type &m) {
-      return m.insert(std::forward<P>(obj)).second;
+      timer.before(m);
+      auto result = m.insert(std::forward<P>(obj));
+      if (result.second)
+        internal::guard_chain(m, result.first->first, _flood_guard);
+      timer.after(m);
+      return result.second;
     });
   }
 
   void insert(const Key &key, const Value &value) {
-    this->execute_exclusive([&](internal_type &m) { m[key] = value; });
+    auto timer = time_operation(internal::operation::insert);
+    this->execute_exclusive([&](internal_type &m) {
+      timer.before(m);
+      m.insert_or_assign(key, value);
+      internal::guard_chain(m, key, _flood_guard);
+      timer.after(m);
+    });
   }
 
   void insert(Key &&key, Value &&value) {
-    this->execute_exclusive(
-        [&](internal_type &m) { m[std::move(key)] = std::move(value); });
+    auto timer = time_operation(internal::operation::insert);
+    this->execute_exclusive([&](internal_type &m) {
+      timer.before(m);
+      auto it = m.insert_or_assign(std::move(key), std::move(value)).first;
+      internal::guard_chain(m, it->first, _flood_guard);
+      timer.after(m);
+    });
+  }
+
+  // Insert a range under a single exclusive lock; existing keys are kept
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void insert(InputIt first, InputIt last) {
+    auto timer = time_operation(internal::operation::insert);
+    this->execute_exclusive([&](internal_type &m) {
+      timer.before(m);
+      m.insert(first, last);
+      internal::guard_table(m, _flood_guard);
+      timer.after(m);
+    });
   }
 
   std::optional<Value> find(const Key &key) const {
+    auto timer = time_operation(internal::operation::find);
     return this->execute_shared(
         [&](const internal_type &m) -> std::optional<Value> {
           auto it = m.find(key);
+          timer.found(it != m.end());
           if (it != m.end()) {
             return it->second; // Returns a copy or moves if Value is movable
           }
@@ -65,35 +126,72 @@ public:
   }
 
   template <typename... Args> bool emplace(Args &&...args) {
+    auto timer = time_operation(internal::operation::insert);
     return this->execute_exclusive([&](internal_type &m) {
-      return m.emplace(std::forward<Args>(args)...).second;
+      timer.before(m);
+      auto result = m.emplace(std::forward<Args>(args)...);
+      if (result.second)
+        internal::guard_chain(m, result.first->first, _flood_guard);
+      timer.after(m);
+      return result.second;
     });
   }
 
   size_t erase(const Key &key) {
+    auto timer = time_operation(internal::operation::erase);
     return this->execute_exclusive(
         [&](internal_type &m) { return m.erase(key); });
   }
 
   void clear() {
-    this->execute_exclusive([](internal_type &m) { m.clear(); });
+    this->execute_exclusive([&](internal_type &m) {
+      m.clear();
+      _flood_guard = {};
+    });
+  }
+
+  void reserve(size_t count) {
+    auto timer = time_operation(internal::operation::rehash);
+    this->execute_exclusive([&](internal_type &m) {
+      timer.before(m);
+      m.reserve(count);
+      timer.after(m);
+    });
+  }
+
+  void rehash(size_t bucket_count) {
+    auto timer = time_operation(internal::operation::rehash);
+    this->execute_exclusive([&](internal_type &m) {
+      timer.before(m);
+      m.rehash(bucket_count);
+      timer.after(m);
+    });
   }
 
   // size() and empty() inherited from base
 
   size_t count(const Key &key) const {
-    return this->execute_shared(
-        [&](const internal_type &m) { return m.count(key); });
+    auto timer = time_operation(internal::operation::find);
+    return this->execute_shared([&](const internal_type &m) {
+      size_t n = m.count(key);
+      timer.found(n > 0);
+      return n;
+    });
   }
 
 #if __cplusplus >= 202002L // Check for C++20 or later
   bool contains(const Key &key) const {
-    return this->execute_shared(
-        [&](const internal_type &m) { return m.contains(key); });
+    auto timer = time_operation(internal::operation::find);
+    return this->execute_shared([&](const internal_type &m) {
+      bool found = m.contains(key);
+      timer.found(found);
+      return found;
+    });
   }
 #endif
 
   std::vector<std::pair<Key, Value>> snapshot() const {
+    auto timer = time_operation(internal::operation::snapshot);
     return this->execute_shared([&](const internal_type &m) {
       std::vector<std::pair<Key, Value>> data;
       data.reserve(m.size());
@@ -103,9 +201,157 @@ public:
     });
   }
 
+  // Call f(key, value) for every element, spread over the workers of pool,
+  // under the shared lock. f runs on several elements at once and must not
+  // call back into this map. Exceptions from f are rethrown here.
+  template <typename F>
+  void parallel_for_each(F &&f,
+                         thread_pool &pool = thread_pool::shared()) const {
+    this->execute_shared([&](const internal_type &m) {
+      internal::parallel_visit(
+          m, pool, [&](const pair_type &pair) { f(pair.first, pair.second); });
+    });
+  }
+
+  // Same under the exclusive lock, with mutable values: f(key, value&) may
+  // update each value in place, e.g. to decay or expire every entry
+  template <typename F>
+  void parallel_update(F &&f, thread_pool &pool = thread_pool::shared()) {
+    this->execute_exclusive([&](internal_type &m) {
+      internal::parallel_visit(
+          m, pool, [&](pair_type &pair) { f(pair.first, pair.second); });
+    });
+  }
+
+  // Load factor, chain lengths, empty buckets and projected shard skew, to
+  // spot a poor Hash in production. At most sample_buckets buckets are
+  // visited under the shared lock.
+  hash_diagnostics diagnostics(size_t sample_buckets = 1024,
+                               size_t shard_count = 16) const {
+    return this->execute_shared([&](const internal_type &m) {
+      return internal::hash_table_diagnostics(m, sample_buckets, shard_count);
+    });
+  }
+
+  // Per-operation counts and latencies since construction. All zero unless
+  // compiled with CONCURRENT_STL_OP_STATS (see operation_stats::enabled).
+  operation_stats op_stats() const {
+#ifdef CONCURRENT_STL_OP_STATS
+    return _op_stats.snapshot();
+#else
+    return {};
+#endif
+  }
+
+  // Estimated heap footprint of the buckets and nodes
+  memory_usage_info memory_usage() const {
+    return this->execute_shared(
+        [](const internal_type &m) { return internal::memory_footprint(m); });
+  }
+
+  // Same, plus out-of-line storage: value_size(key, value) is called for
+  // every element under the shared lock and returns the bytes it owns
+  // outside the node (string buffers, vectors, ...)
+  template <typename ValueSize>
+  memory_usage_info memory_usage(ValueSize &&value_size) const {
+    return this->execute_shared([&](const internal_type &m) {
+      memory_usage_info info = internal::memory_footprint(m);
+      for (const auto &pair : m)
+        info.value_bytes += value_size(pair.first, pair.second);
+      return info;
+    });
+  }
+
   // execute_shared and execute_exclusive inherited from base
 };
 
+// unordered_map on the open-addressed internal::flat_map, for integer and
+// std::string keys with an avalanching hash such as concurrent::hash.
+// Faster lookups and no allocation per element, but code passed to
+// execute_shared() and execute_exclusive() gets a flat_map, whose inserts
+// and erases move elements: iterators and references do not survive them.
+template <typename Key, typename Value, typename Hash = concurrent::hash<Key>,
+          typename MutexT = std::shared_mutex>
+using flat_unordered_map =
+    unordered_map<Key, Value, Hash, std::equal_to<Key>,
+                  std::allocator<std::pair<const Key, Value>>, MutexT,
+                  internal::flat_backend_t<Key, Value, Hash>>;
+
+namespace pmr {
+
+// unordered_map allocating from a std::pmr::memory_resource:
+//   std::pmr::unsynchronized_pool_resource pool;
+//   concurrent::pmr::unordered_map<int, int> map(&pool);
+template <typename Key, typename Value, typename Hash = concurrent::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename MutexT = std::shared_mutex>
+using unordered_map = concurrent::unordered_map<
+    Key, Value, Hash, KeyEqual,
+    std::pmr::polymorphic_allocator<std::pair<const Key, Value>>, MutexT>;
+
+// Bulk-load mode for maps that are built, queried and thrown away as a
+// whole. Nodes and buckets are bump-allocated from a monotonic buffer owned
+// by the map, erased elements are not reused, and destruction releases the
+// buffer in one go. When keys and values are trivially destructible the
+// nodes are not visited at all.
+//
+// Reserve up front: every rehash leaves the old bucket array in the buffer.
+template <typename Key, typename Value, typename Hash = concurrent::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename MutexT = std::shared_mutex>
+class bulk_unordered_map {
+public:
+  using map_type = unordered_map<Key, Value, Hash, KeyEqual, MutexT>;
+
+private:
+  std::pmr::monotonic_buffer_resource _resource;
+  union {
+    map_type _map;
+  };
+
+public:
+  // initial_size: bytes of the first buffer, ideally close to the final
+  // footprint; upstream: where buffers come from
+  explicit bulk_unordered_map(
+      size_t initial_size = 0,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+      : _resource(initial_size ? initial_size : 1024, upstream) {
+    ::new (&_map) map_type(&_resource);
+  }
+
+  bulk_unordered_map(const bulk_unordered_map &) = delete;
+  bulk_unordered_map &operator=(const bulk_unordered_map &) = delete;
+
+  ~bulk_unordered_map() {
+    // Nodes and buckets come from _resource. When nothing in them needs a
+    // destructor, abandon them by building an empty table over the old one;
+    // the map itself is still destroyed, since its lock and operation
+    // statistics own heap memory of their own
+    using container_type = typename map_type::container_type;
+    if constexpr (std::is_trivially_destructible_v<Key> &&
+                  std::is_trivially_destructible_v<Value> &&
+                  std::is_trivially_destructible_v<Hash> &&
+                  std::is_trivially_destructible_v<KeyEqual>) {
+      _map.execute_exclusive([](container_type &m) {
+        auto hash = m.hash_function();
+        auto equal = m.key_eq();
+        auto allocator = m.get_allocator();
+        ::new (&m) container_type(0, hash, equal, allocator);
+      });
+    }
+    _map.~map_type();
+  }
+
+  map_type &map() noexcept { return _map; }
+  const map_type &map() const noexcept { return _map; }
+  map_type *operator->() noexcept { return &_map; }
+  const map_type *operator->() const noexcept { return &_map; }
+
+  std::pmr::memory_resource *resource() noexcept { return &_resource; }
+};
+
+} // namespace pmr
+
 } // namespace concurrent
 
 #endif
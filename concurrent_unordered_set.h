@@ -0,0 +1,126 @@
+#ifndef CONCURRENT_UNORDERED_SET_H
+#define CONCURRENT_UNORDERED_SET_H
+
+#include "concurrent_hash.h"
+#include "internal/container_base.h"
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+// Thread-safe unordered_set on the same foundation as unordered_map. It is
+// always backed by std::unordered_set; there is no flat counterpart to
+// flat_unordered_map.
+template <typename Key, typename Hash = concurrent::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<Key>,
+          typename MutexT = std::shared_mutex>
+class unordered_set
+    : public internal::container_base<
+          std::unordered_set<Key, Hash, KeyEqual, Allocator>, MutexT> {
+public:
+  // What execute_shared() and execute_exclusive() hand out
+  using container_type = std::unordered_set<Key, Hash, KeyEqual, Allocator>;
+
+private:
+  using Base = internal::container_base<container_type, MutexT>;
+  using internal_type = container_type;
+
+public:
+  template <typename... Args>
+  explicit unordered_set(Args &&...args) : Base(std::forward<Args>(args)...) {}
+
+  // Returns true if key was not in the set yet
+  bool insert(const Key &key) {
+    return this->execute_exclusive(
+        [&](internal_type &s) { return s.insert(key).second; });
+  }
+
+  bool insert(Key &&key) {
+    return this->execute_exclusive(
+        [&](internal_type &s) { return s.insert(std::move(key)).second; });
+  }
+
+  template <typename... Args> bool emplace(Args &&...args) {
+    return this->execute_exclusive([&](internal_type &s) {
+      return s.emplace(std::forward<Args>(args)...).second;
+    });
+  }
+
+  // Insert a range under a single exclusive lock; returns how many keys were
+  // new
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::iterator_category>
+  size_t insert(InputIt first, InputIt last) {
+    return this->execute_exclusive([&](internal_type &s) {
+      size_t inserted = 0;
+      for (; first != last; ++first)
+        inserted += s.insert(*first).second;
+      return inserted;
+    });
+  }
+
+  // Same result as insert(key), for workloads where most keys are already
+  // present (de-duplication): those are answered under the shared lock, and
+  // only new keys take the exclusive one.
+  bool insert_if_absent(const Key &key) {
+    if (contains(key))
+      return false;
+    return insert(key);
+  }
+
+  // Batch de-duplication: insert [first, last) under one exclusive lock and
+  // write the keys that were not present before to out, in input order.
+  // Duplicates within the batch are reported once. Returns the end of the
+  // output range.
+  template <typename InputIt, typename OutputIt>
+  OutputIt insert_if_absent(InputIt first, InputIt last, OutputIt out) {
+    return this->execute_exclusive([&](internal_type &s) {
+      for (; first != last; ++first) {
+        auto result = s.insert(*first);
+        if (result.second)
+          *out++ = *result.first;
+      }
+      return out;
+    });
+  }
+
+  size_t erase(const Key &key) {
+    return this->execute_exclusive(
+        [&](internal_type &s) { return s.erase(key); });
+  }
+
+  void clear() {
+    this->execute_exclusive([](internal_type &s) { s.clear(); });
+  }
+
+  void reserve(size_t count) {
+    this->execute_exclusive([&](internal_type &s) { s.reserve(count); });
+  }
+
+  size_t count(const Key &key) const {
+    return this->execute_shared(
+        [&](const internal_type &s) { return s.count(key); });
+  }
+
+  // Available in C++17 too
+  bool contains(const Key &key) const { return count(key) > 0; }
+
+  std::vector<Key> snapshot() const {
+    return this->execute_shared([](const internal_type &s) {
+      return std::vector<Key>(s.begin(), s.end());
+    });
+  }
+
+  // size(), empty(), execute_shared and execute_exclusive inherited from base
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_UNORDERED_SET_H
@@ -0,0 +1,240 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#include "internal/platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace concurrent {
+
+// Append-only array for many writers. Elements live in segments of
+// geometrically growing size (8, 16, 32, ...) that are never moved, so
+// references and indices stay valid for the life of the vector, and
+// operator[] is two loads and no lock.
+//
+// push_back() and grow_by() claim their indices with one fetch_add and
+// construct in place, so appenders only contend on that counter. The thread
+// that first needs a segment allocates it; if several race, one copy wins
+// and the others are freed.
+//
+// size() counts claimed indices, which may include elements still being
+// constructed by other threads. An index returned by push_back() or grow_by()
+// can be read by anyone that learned it from the appending thread;
+// for_each() and snapshot() skip elements that are not constructed yet.
+template <typename T> class vector {
+  struct slot {
+    alignas(T) unsigned char bytes[sizeof(T)];
+    std::atomic<bool> ready{false}; // Set once the element is constructed
+
+    T *get() noexcept { return std::launder(reinterpret_cast<T *>(bytes)); }
+    const T *get() const noexcept {
+      return std::launder(reinterpret_cast<const T *>(bytes));
+    }
+  };
+
+  static constexpr size_t first_segment_bits = 3;
+  static constexpr size_t first_segment_size = size_t(1) << first_segment_bits;
+  static constexpr size_t max_segments = 64 - first_segment_bits;
+
+  std::atomic<slot *> _segments[max_segments] = {};
+  std::atomic<size_t> _size{0};
+
+  static size_t floor_log2(size_t n) noexcept {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, n);
+    return index;
+#else
+    return 63 - static_cast<size_t>(__builtin_clzll(n));
+#endif
+  }
+
+  // Segment k holds indices [first_segment_size * (2^k - 1), ...) and is
+  // twice as large as segment k - 1
+  static size_t segment_of(size_t index) noexcept {
+    return floor_log2(index + first_segment_size) - first_segment_bits;
+  }
+  static size_t segment_start(size_t k) noexcept {
+    return (first_segment_size << k) - first_segment_size;
+  }
+  static size_t segment_size(size_t k) noexcept {
+    return first_segment_size << k;
+  }
+
+  slot *segment(size_t k) {
+    slot *s = _segments[k].load(std::memory_order_acquire);
+    if (s)
+      return s;
+    auto *fresh = new slot[segment_size(k)];
+    if (_segments[k].compare_exchange_strong(s, fresh,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire))
+      return fresh;
+    delete[] fresh;
+    return s;
+  }
+
+  slot &slot_at(size_t index) const noexcept {
+    size_t k = segment_of(index);
+    return _segments[k].load(std::memory_order_acquire)
+        [index - segment_start(k)];
+  }
+
+  slot &checked_slot(size_t index) const {
+    if (index < size()) {
+      size_t k = segment_of(index);
+      slot *s = _segments[k].load(std::memory_order_acquire);
+      if (s) {
+        slot &found = s[index - segment_start(k)];
+        if (found.ready.load(std::memory_order_acquire))
+          return found;
+      }
+    }
+    throw std::out_of_range("concurrent::vector::at");
+  }
+
+  template <typename... Args> void construct(size_t index, Args &&...args) {
+    size_t k = segment_of(index);
+    slot &s = segment(k)[index - segment_start(k)];
+    new (s.bytes) T(std::forward<Args>(args)...);
+    s.ready.store(true, std::memory_order_release);
+  }
+
+  // Claim n indices and make sure their segments exist
+  size_t claim(size_t n) {
+    size_t first = _size.fetch_add(n, std::memory_order_relaxed);
+    if (n > 0)
+      for (size_t k = segment_of(first), last = segment_of(first + n - 1);
+           k <= last; ++k)
+        segment(k);
+    return first;
+  }
+
+  template <typename Self, typename F> static void visit(Self &self, F &f) {
+    size_t n = self.size();
+    for (size_t k = 0; k < max_segments && segment_start(k) < n; ++k) {
+      // Claimed indices can be ahead of their segment's allocation; nothing
+      // in a missing segment is constructed yet
+      slot *s = self._segments[k].load(std::memory_order_acquire);
+      if (!s)
+        continue;
+      size_t start = segment_start(k);
+      size_t count = std::min(segment_size(k), n - start);
+      for (size_t i = 0; i < count; ++i)
+        if (s[i].ready.load(std::memory_order_acquire))
+          f(start + i, *s[i].get());
+    }
+  }
+
+public:
+  vector() = default;
+
+  vector(const vector &) = delete;
+  vector &operator=(const vector &) = delete;
+
+  /// No thread may be using the vector
+  ~vector() {
+    for (size_t k = 0; k < max_segments; ++k) {
+      slot *s = _segments[k].load(std::memory_order_relaxed);
+      if (!s)
+        continue;
+      if constexpr (!std::is_trivially_destructible_v<T>)
+        for (size_t i = 0; i < segment_size(k); ++i)
+          if (s[i].ready.load(std::memory_order_relaxed))
+            s[i].get()->~T();
+      delete[] s;
+    }
+  }
+
+  /// Allocate the segments for the first n indices up front
+  void reserve(size_t n) {
+    if (n > 0)
+      for (size_t k = 0, last = segment_of(n - 1); k <= last; ++k)
+        segment(k);
+  }
+
+  /// Returns the index of the new element. If the constructor throws, the
+  /// index stays claimed but empty: for_each() and snapshot() skip it.
+  template <typename... Args> size_t emplace_back(Args &&...args) {
+    size_t index = claim(1);
+    construct(index, std::forward<Args>(args)...);
+    return index;
+  }
+
+  size_t push_back(const T &value) { return emplace_back(value); }
+  size_t push_back(T &&value) { return emplace_back(std::move(value)); }
+
+  /// Append n copies of value at consecutive indices; returns the first one
+  size_t grow_by(size_t n, const T &value = T()) {
+    size_t first = claim(n);
+    for (size_t i = 0; i < n; ++i)
+      construct(first + i, value);
+    return first;
+  }
+
+  /// Append [first, last) at consecutive indices; returns the first one
+  template <typename ForwardIt,
+            typename = typename std::iterator_traits<ForwardIt>::iterator_category>
+  size_t grow_by(ForwardIt first, ForwardIt last) {
+    size_t start = claim(static_cast<size_t>(std::distance(first, last)));
+    for (size_t i = start; first != last; ++first, ++i)
+      construct(i, *first);
+    return start;
+  }
+
+  /// index must have been returned to, or published by, an appending thread
+  T &operator[](size_t index) noexcept { return *slot_at(index).get(); }
+  const T &operator[](size_t index) const noexcept {
+    return *slot_at(index).get();
+  }
+
+  /// Checked access for indices from any source: throws std::out_of_range
+  /// unless the element at index has been constructed
+  T &at(size_t index) { return *checked_slot(index).get(); }
+  const T &at(size_t index) const { return *checked_slot(index).get(); }
+
+  /// Call f(index, element) for the constructed elements in index order.
+  /// Appends that happen during the call may or may not be visited.
+  template <typename F> void for_each(F &&f) { visit(*this, f); }
+  template <typename F> void for_each(F &&f) const {
+    auto as_const = [&](size_t index, T &value) {
+      f(index, static_cast<const T &>(value));
+    };
+    visit(*this, as_const);
+  }
+
+  /// Copy of the constructed elements, in index order
+  std::vector<T> snapshot() const {
+    std::vector<T> data;
+    data.reserve(size());
+    for_each([&](size_t, const T &value) { data.push_back(value); });
+    return data;
+  }
+
+  /// Indices claimed so far, including elements still being constructed
+  size_t size() const noexcept { return _size.load(std::memory_order_relaxed); }
+  bool empty() const noexcept { return size() == 0; }
+
+  /// Elements that fit in the segments allocated so far
+  size_t capacity() const noexcept {
+    size_t k = 0;
+    while (k < max_segments && _segments[k].load(std::memory_order_relaxed))
+      ++k;
+    return segment_start(k);
+  }
+};
+
+} // namespace concurrent
+
+#endif // CONCURRENT_VECTOR_H
@@ -1,6 +1,7 @@
 #ifndef CONCURRENT_CONTAINER_BASE_H
 #define CONCURRENT_CONTAINER_BASE_H
 
+#include "lock_stats.h"
 #include <functional>
 #include <mutex>
 #include <optional>
@@ -18,6 +19,9 @@ class container_base {
 protected:
   ContainerT _internal_container;
   mutable MutexT _mutex;
+#ifdef CONCURRENT_STL_LOCK_STATS
+  mutable internal::lock_recorder _lock_stats;
+#endif
 
 public:
   // Constructor: forward parameters to the underlying container's constructor
@@ -53,7 +57,13 @@ public:
   template <typename Func>
   auto execute_shared(Func &&func) const
       -> decltype(func(std::declval<const ContainerT &>())) {
+#ifdef CONCURRENT_STL_LOCK_STATS
+    std::shared_lock<MutexT> lock(_mutex, std::defer_lock);
+    internal::lock_stats_scope<std::shared_lock<MutexT>> timing(
+        _lock_stats.shared(), lock);
+#else
     std::shared_lock<MutexT> lock(_mutex);
+#endif
     return func(_internal_container);
   }
 
@@ -62,10 +72,27 @@ public:
   template <typename Func>
   auto execute_exclusive(Func &&func)
       -> decltype(func(std::declval<ContainerT &>())) {
+#ifdef CONCURRENT_STL_LOCK_STATS
+    std::unique_lock<MutexT> lock(_mutex, std::defer_lock);
+    internal::lock_stats_scope<std::unique_lock<MutexT>> timing(
+        _lock_stats.exclusive(), lock);
+#else
     std::unique_lock<MutexT> lock(_mutex);
+#endif
     return func(_internal_container);
   }
 
+  /// Same as execute_exclusive() if the lock is free right now; otherwise
+  /// returns false without calling func. For housekeeping that may be
+  /// skipped when another thread holds the lock.
+  template <typename Func> bool try_execute_exclusive(Func &&func) {
+    std::unique_lock<MutexT> lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+      return false;
+    func(_internal_container);
+    return true;
+  }
+
   // You can add some common, non-container-specific interfaces here,
   // for example size() and empty(), which can be implemented directly using
   // execute_shared.
@@ -76,6 +103,16 @@ public:
   bool empty() const {
     return execute_shared([](const ContainerT &c) { return c.empty(); });
   }
+
+  /// Contention statistics of _mutex since construction. All zero unless
+  /// compiled with CONCURRENT_STL_LOCK_STATS (see lock_stats::enabled).
+  lock_stats stats() const {
+#ifdef CONCURRENT_STL_LOCK_STATS
+    return _lock_stats.snapshot();
+#else
+    return lock_stats();
+#endif
+  }
 };
 
 } // namespace concurrent::internal
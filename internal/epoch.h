@@ -0,0 +1,216 @@
+#ifndef CONCURRENT_EPOCH_H
+#define CONCURRENT_EPOCH_H
+
+#include "platform.h"
+#include "thread_registry.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace concurrent::internal {
+
+class epoch_domain;
+
+// A node that has been unlinked but may still be read by pinned threads
+struct retired_node {
+  void *ptr;
+  void (*deleter)(void *);
+  std::uint64_t epoch;
+};
+
+// Per-thread state of an epoch_domain. The pinned flag and the observed
+// epoch share one word so the collector reads them with a single load.
+struct epoch_record {
+  alignas(cache_line_size) std::atomic<std::uint64_t> state{0};
+  std::atomic<bool> in_use{false};
+  epoch_record *next = nullptr;
+  epoch_domain *owner;
+  unsigned nesting = 0;
+  std::size_t since_collect = 0;
+  std::deque<retired_node> limbo; // Ordered by retire epoch
+
+  explicit epoch_record(epoch_domain &domain) : owner(&domain) {}
+
+  static constexpr std::uint64_t pinned_bit = 1;
+
+  inline void on_thread_exit();
+};
+
+/// Epoch-based memory reclamation.
+///
+/// Readers pin the domain for the duration of an operation; writers unlink a
+/// node and hand it to retire(). The node is freed once every thread that
+/// could have observed it has unpinned, i.e. after the global epoch has
+/// advanced twice past the epoch it was retired in. Retired nodes are kept in
+/// a per-thread limbo list and freed in batches.
+///
+/// A thread that stays pinned blocks reclamation for everyone, so keep
+/// critical sections short. hazard_domain (hazard_pointer.h) bounds the
+/// garbage instead, at a higher per-read cost.
+class epoch_domain {
+  friend struct epoch_record;
+
+  alignas(cache_line_size) std::atomic<std::uint64_t> _epoch{2};
+  std::atomic<std::size_t> _pending{0};
+  std::size_t _collect_threshold;
+  thread_registry<epoch_record, epoch_domain> _records;
+
+  // Nodes left behind by exited threads
+  std::mutex _orphans_mutex;
+  std::deque<retired_node> _orphans;
+  std::atomic<bool> _has_orphans{false};
+
+  static std::size_t free_eligible(std::deque<retired_node> &nodes,
+                                   std::uint64_t epoch) {
+    std::size_t freed = 0;
+    while (!nodes.empty() && nodes.front().epoch + 2 <= epoch) {
+      retired_node node = nodes.front();
+      nodes.pop_front();
+      node.deleter(node.ptr);
+      ++freed;
+    }
+    return freed;
+  }
+
+  bool try_advance() {
+    // Sequentially consistent operations instead of fences: they pair with
+    // the exchange in guard() and are understood by ThreadSanitizer
+    std::uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+    bool blocked = false;
+    _records.for_each([&](const epoch_record &r) {
+      std::uint64_t state = r.state.load(std::memory_order_seq_cst);
+      if ((state & epoch_record::pinned_bit) && (state >> 1) != epoch)
+        blocked = true;
+    });
+    if (blocked)
+      return false;
+    return _epoch.compare_exchange_strong(epoch, epoch + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed);
+  }
+
+  void collect(epoch_record &record) {
+    record.since_collect = 0;
+    try_advance();
+    std::uint64_t epoch = _epoch.load(std::memory_order_acquire);
+    std::size_t freed = free_eligible(record.limbo, epoch);
+    if (_has_orphans.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(_orphans_mutex);
+      freed += free_eligible(_orphans, epoch);
+      _has_orphans.store(!_orphans.empty(), std::memory_order_relaxed);
+    }
+    _pending.fetch_sub(freed, std::memory_order_relaxed);
+  }
+
+  void adopt(std::deque<retired_node> &nodes) {
+    if (nodes.empty())
+      return;
+    std::lock_guard<std::mutex> lock(_orphans_mutex);
+    for (auto &node : nodes)
+      _orphans.push_back(node);
+    nodes.clear();
+    _has_orphans.store(true, std::memory_order_relaxed);
+  }
+
+public:
+  /// RAII pin; nodes reachable when the guard was taken stay valid until it
+  /// is destroyed. Guards nest.
+  class guard {
+    epoch_record *_record;
+
+  public:
+    explicit guard(epoch_record &record) : _record(&record) {
+      if (record.nesting++ == 0) {
+        std::uint64_t epoch =
+            record.owner->_epoch.load(std::memory_order_relaxed);
+        record.state.exchange((epoch << 1) | epoch_record::pinned_bit,
+                              std::memory_order_seq_cst);
+      }
+    }
+
+    guard(guard &&other) noexcept : _record(other._record) {
+      other._record = nullptr;
+    }
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+    guard &operator=(guard &&) = delete;
+
+    ~guard() {
+      if (_record && --_record->nesting == 0)
+        _record->state.store(0, std::memory_order_release);
+    }
+  };
+
+  /// collect_threshold: number of retirements after which a thread tries to
+  /// advance the epoch and free its limbo list
+  explicit epoch_domain(std::size_t collect_threshold = 64)
+      : _collect_threshold(collect_threshold ? collect_threshold : 1),
+        _records(*this) {}
+
+  epoch_domain(const epoch_domain &) = delete;
+  epoch_domain &operator=(const epoch_domain &) = delete;
+
+  /// No thread may be pinned or retiring when the domain is destroyed.
+  /// Everything still in limbo is freed.
+  ~epoch_domain() {
+    _records.detach();
+    _records.for_each([](epoch_record &r) {
+      for (auto &node : r.limbo)
+        node.deleter(node.ptr);
+      r.limbo.clear();
+    });
+    for (auto &node : _orphans)
+      node.deleter(node.ptr);
+  }
+
+  /// Process-wide domain for containers that do not need their own
+  static epoch_domain &global() {
+    static epoch_domain domain;
+    return domain;
+  }
+
+  guard pin() { return guard(_records.local()); }
+
+  /// Hand over a node that is no longer reachable from the shared structure.
+  /// The deleter runs once no pinned thread can still hold a reference.
+  void retire(void *ptr, void (*deleter)(void *)) {
+    epoch_record &record = _records.local();
+    record.limbo.push_back(
+        {ptr, deleter, _epoch.load(std::memory_order_seq_cst)});
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    if (++record.since_collect >= _collect_threshold)
+      collect(record);
+  }
+
+  template <typename T> void retire(T *ptr) {
+    retire(static_cast<void *>(ptr),
+           [](void *p) { delete static_cast<T *>(p); });
+  }
+
+  /// Try to advance the epoch and free whatever has become safe
+  void collect() { collect(_records.local()); }
+
+  /// Nodes retired but not yet freed, across all threads
+  std::size_t pending() const {
+    return _pending.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t epoch() const {
+    return _epoch.load(std::memory_order_relaxed);
+  }
+};
+
+inline void epoch_record::on_thread_exit() {
+  nesting = 0;
+  since_collect = 0;
+  state.store(0, std::memory_order_release);
+  owner->adopt(limbo);
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_EPOCH_H
@@ -0,0 +1,650 @@
+#ifndef CONCURRENT_FLAT_MAP_H
+#define CONCURRENT_FLAT_MAP_H
+
+#include "hash_diagnostics.h"
+#include "memory_usage.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concurrent::internal {
+
+// Slot layout for integer keys: the key itself, so a probe compares keys
+// without touching the elements. The largest key value marks empty slots;
+// an element with that key is kept outside the table.
+template <typename Key, typename Hash> struct integer_slots {
+  using lookup_type = Key;
+
+  static constexpr Key empty_key = std::numeric_limits<Key>::max();
+
+  struct slot {
+    Key key;
+    size_t index;
+  };
+
+  static constexpr slot empty_slot() noexcept { return {empty_key, 0}; }
+  static bool is_empty(const slot &s) noexcept { return s.key == empty_key; }
+  static bool out_of_band(Key key) noexcept { return key == empty_key; }
+
+  static size_t hash(const Hash &hasher, Key key) noexcept {
+    return hasher(key);
+  }
+  static size_t slot_hash(const slot &s, const Hash &hasher) noexcept {
+    return hasher(s.key);
+  }
+
+  template <typename Element>
+  static bool matches(const slot &s, Key key, size_t, const Element *) noexcept {
+    return s.key == key;
+  }
+
+  static slot make(Key key, size_t, size_t index) noexcept {
+    return {key, index};
+  }
+};
+
+// Slot layout for std::string keys. The full hash is kept as a fingerprint,
+// so a probe rejects other keys without reading them, and keys of up to
+// inline_capacity bytes are copied into the slot, so a hit on a short key
+// is confirmed without dereferencing the element either. A slot is half a
+// cache line. Hash 0 marks empty slots and is remapped to 1.
+template <typename Hash> struct string_slots {
+  using lookup_type = std::string_view;
+
+  static constexpr size_t inline_capacity = 15;
+  static constexpr uint8_t out_of_line = 0xff;
+
+  struct slot {
+    size_t hash;
+    size_t index;
+    uint8_t length; // out_of_line for longer keys
+    char chars[inline_capacity];
+  };
+
+  static constexpr slot empty_slot() noexcept { return {0, 0, 0, {}}; }
+  static bool is_empty(const slot &s) noexcept { return s.hash == 0; }
+  static bool out_of_band(std::string_view) noexcept { return false; }
+
+  static size_t hash(const Hash &hasher, std::string_view key) noexcept {
+    size_t h = hasher(key);
+    return h ? h : 1;
+  }
+  static size_t slot_hash(const slot &s, const Hash &) noexcept {
+    return s.hash;
+  }
+
+  template <typename Element>
+  static bool matches(const slot &s, std::string_view key, size_t hash,
+                      const Element *elements) noexcept {
+    if (s.hash != hash)
+      return false;
+    if (s.length != out_of_line)
+      return s.length == key.size() &&
+             std::memcmp(s.chars, key.data(), key.size()) == 0;
+    return elements[s.index].first == key;
+  }
+
+  static slot make(std::string_view key, size_t hash, size_t index) noexcept {
+    slot s = empty_slot();
+    s.hash = hash;
+    s.index = index;
+    if (key.size() <= inline_capacity) {
+      s.length = static_cast<uint8_t>(key.size());
+      std::memcpy(s.chars, key.data(), key.size());
+    } else {
+      s.length = out_of_line;
+    }
+    return s;
+  }
+};
+
+/// Open-addressed hash map, used as the backend of concurrent::unordered_map
+/// for integer and std::string keys (see map_backend.h).
+///
+/// Elements live in a dense array; the table itself is an array of slots
+/// probed linearly, each holding the element's index plus whatever Slots
+/// keeps inline to reject mismatches without chasing a pointer: the key for
+/// integers, a fingerprint and short keys for strings. Erase uses
+/// backward-shift deletion (no tombstones) and moves the last element into
+/// the hole, so iteration stays a linear scan.
+///
+/// The interface is the subset of std::unordered_map the containers and
+/// execute_shared()/execute_exclusive() callers use. Lookups take
+/// Slots::lookup_type, so string maps can be searched with a string_view
+/// without building a std::string. Unlike std::unordered_map, every insert
+/// and erase may invalidate iterators and references.
+///
+/// Hash must mix all bits into the low ones (concurrent::hash does).
+template <typename Key, typename Value, typename Hash,
+          typename Slots = integer_slots<Key, Hash>>
+class flat_map {
+public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = std::equal_to<Key>;
+  using allocator_type = std::allocator<value_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = value_type *;
+  using const_iterator = const value_type *;
+  using lookup_type = typename Slots::lookup_type;
+
+private:
+  using slot = typename Slots::slot;
+
+  // Element storage. Iterators see value, whose key is const; relocation
+  // (growth, and erase filling its hole) goes through mutable_value, the
+  // same pair with a non-const key, so that keys such as std::string are
+  // moved rather than copied. absl's flat_hash_map slots do the same.
+  union element {
+    value_type value;
+    std::pair<Key, Value> mutable_value;
+
+    element() noexcept {}
+    ~element() {}
+  };
+  using element_allocator = std::allocator<element>;
+
+  static_assert(sizeof(element) == sizeof(value_type),
+                "elements are iterated as an array of value_type");
+  static_assert(std::is_nothrow_move_constructible_v<Key> &&
+                    std::is_nothrow_move_constructible_v<Value>,
+                "flat_map relocates elements and needs nothrow moves");
+
+  static constexpr size_t no_index = std::numeric_limits<size_t>::max();
+  static constexpr size_t min_slots = 8;
+
+  std::vector<slot> _slots; // Power-of-two size, or empty
+  size_t _mask = 0;
+  value_type *_values = nullptr; // Points into an array of element
+  size_t _size = 0;
+  size_t _capacity = 0;
+  size_t _out_of_band_index = no_index; // See Slots::out_of_band
+  float _max_load_factor = 0.5f;
+  Hash _hasher;
+
+  size_t hash(lookup_type key) const noexcept {
+    return Slots::hash(_hasher, key);
+  }
+
+  size_t find_index(lookup_type key, size_t h) const noexcept {
+    if (Slots::out_of_band(key))
+      return _out_of_band_index;
+    if (_slots.empty())
+      return no_index;
+    size_t i = h & _mask;
+    while (!Slots::is_empty(_slots[i]) &&
+           !Slots::matches(_slots[i], key, h, _values))
+      i = (i + 1) & _mask;
+    return Slots::is_empty(_slots[i]) ? no_index : _slots[i].index;
+  }
+
+  size_t find_index(lookup_type key) const noexcept {
+    return find_index(key, Slots::out_of_band(key) ? 0 : hash(key));
+  }
+
+  // Slot pointing at the element with this index, which must be in the table
+  size_t slot_of(size_t index) const noexcept {
+    size_t i = hash(_values[index].first) & _mask;
+    while (_slots[i].index != index || Slots::is_empty(_slots[i]))
+      i = (i + 1) & _mask;
+    return i;
+  }
+
+  void place(const slot &s) noexcept {
+    size_t i = Slots::slot_hash(s, _hasher) & _mask;
+    while (!Slots::is_empty(_slots[i]))
+      i = (i + 1) & _mask;
+    _slots[i] = s;
+  }
+
+  void link(size_t index, size_t h) noexcept {
+    lookup_type key = _values[index].first;
+    if (Slots::out_of_band(key))
+      _out_of_band_index = index;
+    else
+      place(Slots::make(key, h, index));
+  }
+
+  // Remove the element's slot, shifting later members of its probe run back
+  // so that lookups never stop early at the hole
+  void unlink(size_t index) noexcept {
+    if (Slots::out_of_band(_values[index].first)) {
+      _out_of_band_index = no_index;
+      return;
+    }
+    size_t hole = slot_of(index);
+    for (size_t next = (hole + 1) & _mask; !Slots::is_empty(_slots[next]);
+         next = (next + 1) & _mask) {
+      size_t home = Slots::slot_hash(_slots[next], _hasher) & _mask;
+      // The slot may fill the hole if the hole lies on its probe path
+      if (((hole - home) & _mask) < ((next - home) & _mask)) {
+        _slots[hole] = _slots[next];
+        hole = next;
+      }
+    }
+    _slots[hole] = Slots::empty_slot();
+  }
+
+  size_t slots_for(size_t count) const {
+    size_t needed = static_cast<size_t>(
+        std::ceil(static_cast<double>(count) / _max_load_factor));
+    size_t n = min_slots;
+    while (n < needed)
+      n <<= 1;
+    return n;
+  }
+
+  // Slots are moved as they are; string fingerprints are not recomputed
+  void rebuild(size_t slot_count) {
+    std::vector<slot> old(slot_count, Slots::empty_slot());
+    old.swap(_slots);
+    _mask = slot_count - 1;
+    for (const slot &s : old)
+      if (!Slots::is_empty(s))
+        place(s);
+  }
+
+  static std::pair<Key, Value> &mutable_value(value_type *p) noexcept {
+    return reinterpret_cast<element *>(p)->mutable_value;
+  }
+
+  // Move the element at from into the raw storage at to
+  static void relocate(value_type *from, value_type *to) noexcept {
+    ::new (&mutable_value(to))
+        std::pair<Key, Value>(std::move(mutable_value(from)));
+    from->~value_type();
+  }
+
+  void reserve_values(size_t count) {
+    if (count <= _capacity)
+      return;
+    element *elements = element_allocator().allocate(count);
+    value_type *values = &elements->value;
+    for (size_t i = 0; i < _size; ++i)
+      relocate(_values + i, values + i);
+    deallocate_values();
+    _values = values;
+    _capacity = count;
+  }
+
+  void deallocate_values() noexcept {
+    if (_values)
+      element_allocator().deallocate(reinterpret_cast<element *>(_values),
+                                     _capacity);
+  }
+
+  // Room for one more element in both arrays
+  void grow_for_insert() {
+    if (_slots.empty() || _size + 1 > _max_load_factor * _slots.size())
+      rebuild(slots_for(_size + 1));
+    if (_size == _capacity)
+      reserve_values(std::max(min_slots, 2 * _capacity));
+  }
+
+  static void destroy(value_type *values, size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>)
+      for (size_t i = 0; i < count; ++i)
+        values[i].~value_type();
+  }
+
+  void release() noexcept {
+    destroy(_values, _size);
+    deallocate_values();
+    _values = nullptr;
+    _size = _capacity = 0;
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace_impl(K &&key, Args &&...args) {
+    lookup_type lookup = key;
+    size_t h = Slots::out_of_band(lookup) ? 0 : hash(lookup);
+    size_t index = find_index(lookup, h);
+    if (index != no_index)
+      return {_values + index, false};
+    grow_for_insert();
+    ::new (_values + _size)
+        value_type(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    link(_size, h);
+    return {_values + _size++, true};
+  }
+
+  void erase_at(size_t index) noexcept {
+    unlink(index);
+    size_t last = _size - 1;
+    if (index != last) {
+      // Move the last element into the hole and repoint its slot
+      if (Slots::out_of_band(_values[last].first))
+        _out_of_band_index = index;
+      else
+        _slots[slot_of(last)].index = index;
+      _values[index].~value_type();
+      relocate(_values + last, _values + index);
+    } else {
+      _values[last].~value_type();
+    }
+    --_size;
+  }
+
+public:
+  flat_map() = default;
+
+  explicit flat_map(size_t bucket_count, const Hash &hash = Hash())
+      : _hasher(hash) {
+    if (bucket_count)
+      rehash(bucket_count);
+  }
+
+  // Delegates so that the destructor cleans up if copying a value throws
+  flat_map(const flat_map &other) : flat_map(0, other._hasher) {
+    _max_load_factor = other._max_load_factor;
+    reserve_values(other._size);
+    for (; _size < other._size; ++_size)
+      ::new (_values + _size) value_type(other._values[_size]);
+    _slots = other._slots;
+    _mask = other._mask;
+    _out_of_band_index = other._out_of_band_index;
+  }
+
+  flat_map(flat_map &&other) noexcept
+      : _slots(std::move(other._slots)), _mask(other._mask),
+        _values(other._values), _size(other._size),
+        _capacity(other._capacity),
+        _out_of_band_index(other._out_of_band_index),
+        _max_load_factor(other._max_load_factor), _hasher(other._hasher) {
+    other._slots.clear();
+    other._mask = 0;
+    other._values = nullptr;
+    other._size = other._capacity = 0;
+    other._out_of_band_index = no_index;
+  }
+
+  flat_map &operator=(const flat_map &other) {
+    if (this != &other) {
+      flat_map copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  flat_map &operator=(flat_map &&other) noexcept {
+    if (this != &other) {
+      flat_map moved(std::move(other));
+      swap(moved);
+    }
+    return *this;
+  }
+
+  ~flat_map() { release(); }
+
+  void swap(flat_map &other) noexcept {
+    using std::swap;
+    swap(_slots, other._slots);
+    swap(_mask, other._mask);
+    swap(_values, other._values);
+    swap(_size, other._size);
+    swap(_capacity, other._capacity);
+    swap(_out_of_band_index, other._out_of_band_index);
+    swap(_max_load_factor, other._max_load_factor);
+    swap(_hasher, other._hasher);
+  }
+
+  iterator begin() noexcept { return _values; }
+  iterator end() noexcept { return _values + _size; }
+  const_iterator begin() const noexcept { return _values; }
+  const_iterator end() const noexcept { return _values + _size; }
+  const_iterator cbegin() const noexcept { return _values; }
+  const_iterator cend() const noexcept { return _values + _size; }
+
+  bool empty() const noexcept { return _size == 0; }
+  size_t size() const noexcept { return _size; }
+
+  void clear() noexcept {
+    destroy(_values, _size);
+    _size = 0;
+    std::fill(_slots.begin(), _slots.end(), Slots::empty_slot());
+    _out_of_band_index = no_index;
+  }
+
+  iterator find(lookup_type key) noexcept {
+    size_t index = find_index(key);
+    return index == no_index ? end() : _values + index;
+  }
+  const_iterator find(lookup_type key) const noexcept {
+    size_t index = find_index(key);
+    return index == no_index ? end() : _values + index;
+  }
+
+  size_t count(lookup_type key) const noexcept {
+    return find_index(key) != no_index;
+  }
+  bool contains(lookup_type key) const noexcept {
+    return find_index(key) != no_index;
+  }
+
+  Value &at(lookup_type key) {
+    size_t index = find_index(key);
+    if (index == no_index)
+      throw std::out_of_range("flat_map::at");
+    return _values[index].second;
+  }
+  const Value &at(lookup_type key) const {
+    size_t index = find_index(key);
+    if (index == no_index)
+      throw std::out_of_range("flat_map::at");
+    return _values[index].second;
+  }
+
+  Value &operator[](const Key &key) { return try_emplace_impl(key).first->second; }
+  Value &operator[](Key &&key) {
+    return try_emplace_impl(std::move(key)).first->second;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return try_emplace_impl(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+    return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+    auto result = try_emplace_impl(key, std::forward<M>(obj));
+    if (!result.second)
+      result.first->second = std::forward<M>(obj);
+    return result;
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+    auto result = try_emplace_impl(std::move(key), std::forward<M>(obj));
+    if (!result.second)
+      result.first->second = std::forward<M>(obj);
+    return result;
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return try_emplace_impl(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(value_type &&value) {
+    return emplace(std::move(value));
+  }
+  template <typename P, typename std::enable_if_t<
+                            std::is_constructible_v<value_type, P &&>, int> = 0>
+  std::pair<iterator, bool> insert(P &&obj) {
+    return emplace(std::forward<P>(obj));
+  }
+  template <typename InputIt> void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  // The element is built aside first, as its key is only known then, and
+  // moved in only if the key is new; a duplicate leaves the table as it was
+  template <typename... Args> std::pair<iterator, bool> emplace(Args &&...args) {
+    std::pair<Key, Value> candidate(std::forward<Args>(args)...);
+    lookup_type key = candidate.first;
+    size_t h = Slots::out_of_band(key) ? 0 : hash(key);
+    size_t index = find_index(key, h);
+    if (index != no_index)
+      return {_values + index, false};
+    grow_for_insert();
+    ::new (&mutable_value(_values + _size))
+        std::pair<Key, Value>(std::move(candidate));
+    link(_size, h);
+    return {_values + _size++, true};
+  }
+
+  size_t erase(lookup_type key) {
+    size_t index = find_index(key);
+    if (index == no_index)
+      return 0;
+    erase_at(index);
+    return 1;
+  }
+
+  // Returns the element that took its place, i.e. erasing while iterating
+  // visits every element once: for (it = begin(); it != end();) if (...)
+  // it = erase(it); else ++it;
+  iterator erase(const_iterator pos) {
+    size_t index = static_cast<size_t>(pos - _values);
+    erase_at(index);
+    return _values + index;
+  }
+
+  size_t bucket_count() const noexcept { return _slots.size(); }
+
+  float load_factor() const noexcept {
+    return _slots.empty() ? 0.0f
+                          : static_cast<float>(_size) / _slots.size();
+  }
+
+  float max_load_factor() const noexcept { return _max_load_factor; }
+
+  // Linear probing degrades quickly above ~0.8, so larger values are capped
+  void max_load_factor(float ml) {
+    _max_load_factor = std::clamp(ml, 0.125f, 0.875f);
+    if (!_slots.empty() && _size > _max_load_factor * _slots.size())
+      rebuild(slots_for(_size));
+  }
+
+  // Like std::unordered_map: at least count slots, and enough for size()
+  void rehash(size_t count) {
+    size_t n = slots_for(_size);
+    while (n < count)
+      n <<= 1;
+    if (n != _slots.size())
+      rebuild(n);
+  }
+
+  void reserve(size_t count) {
+    if (slots_for(count) > _slots.size())
+      rebuild(slots_for(count));
+    reserve_values(count);
+  }
+
+  hasher hash_function() const { return _hasher; }
+  key_equal key_eq() const { return key_equal(); }
+  allocator_type get_allocator() const noexcept { return allocator_type(); }
+
+  // Introspection for diagnostics and memory accounting
+
+  size_t value_capacity() const noexcept { return _capacity; }
+
+  static constexpr size_t slot_size = sizeof(slot);
+
+  bool slot_empty(size_t i) const noexcept {
+    return Slots::is_empty(_slots[i]);
+  }
+
+  size_t slot_hash(size_t i) const noexcept {
+    return Slots::slot_hash(_slots[i], _hasher);
+  }
+
+  // Slots a lookup of the key in slot i inspects, 1 if it sits at its home
+  size_t probe_length(size_t i) const noexcept {
+    return ((i - slot_hash(i)) & _mask) + 1;
+  }
+};
+
+// The dense array is counted as node storage, the slot array as buckets
+template <typename Key, typename Value, typename Hash, typename Slots>
+memory_usage_info memory_footprint(const flat_map<Key, Value, Hash, Slots> &m) {
+  using map_type = flat_map<Key, Value, Hash, Slots>;
+  memory_usage_info info;
+  info.bucket_bytes = round_allocation(m.bucket_count() * map_type::slot_size);
+  info.node_bytes = round_allocation(m.value_capacity() *
+                                     sizeof(typename map_type::value_type));
+  return info;
+}
+
+// Chain lengths are probe lengths here: a sampled occupied slot counts as a
+// chain of the slots a lookup of its key visits. With linear probing a
+// uniform hash leaves 1 - load_factor of the slots empty.
+template <typename Key, typename Value, typename Hash, typename Slots>
+hash_diagnostics
+hash_table_diagnostics(const flat_map<Key, Value, Hash, Slots> &m,
+                       size_t sample_limit, size_t shard_count) {
+  hash_diagnostics d;
+  d.size = m.size();
+  d.bucket_count = m.bucket_count();
+  d.load_factor = m.load_factor();
+  d.max_load_factor = m.max_load_factor();
+  d.expected_empty_bucket_fraction = 1.0 - d.load_factor;
+  d.shard_count = shard_count ? shard_count : 1;
+
+  if (d.bucket_count == 0)
+    return d;
+  size_t stride = sample_limit && d.bucket_count > sample_limit
+                      ? d.bucket_count / sample_limit
+                      : 1;
+
+  std::vector<size_t> shards(d.shard_count, 0);
+  size_t empty = 0, occupied = 0, probes = 0;
+  for (size_t i = 0; i < d.bucket_count; i += stride) {
+    ++d.sampled_buckets;
+    if (m.slot_empty(i)) {
+      ++empty;
+      continue;
+    }
+    ++occupied;
+    size_t length = m.probe_length(i);
+    probes += length;
+    d.max_chain_length = std::max(d.max_chain_length, length);
+    ++shards[m.slot_hash(i) % d.shard_count];
+  }
+
+  d.empty_bucket_fraction = static_cast<double>(empty) / d.sampled_buckets;
+  d.avg_chain_length =
+      occupied ? static_cast<double>(probes) / occupied : 0.0;
+  if (occupied) {
+    double mean = static_cast<double>(occupied) / d.shard_count;
+    d.shard_imbalance =
+        *std::max_element(shards.begin(), shards.end()) / mean;
+  }
+  return d;
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_FLAT_MAP_H
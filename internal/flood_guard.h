@@ -0,0 +1,88 @@
+#ifndef CONCURRENT_FLOOD_GUARD_H
+#define CONCURRENT_FLOOD_GUARD_H
+
+#include "hash_functions.h"
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace concurrent::internal {
+
+// Hashers that can be rebuilt with a new seed (see concurrent::seeded_hash)
+template <typename Hash, typename = void>
+struct is_seeded_hash : std::false_type {};
+
+template <typename Hash>
+struct is_seeded_hash<Hash, std::void_t<typename Hash::is_seeded>>
+    : std::true_type {};
+
+// With a keyed hash and the default load factor a chain this long has a
+// probability far below 1e-20; seeing one means the keys were chosen to
+// collide (or the seed leaked)
+inline constexpr size_t flood_chain_threshold = 32;
+
+// Move every node into a table hashed with a fresh seed. Nodes are relinked,
+// not reallocated, so references to elements stay valid.
+template <typename Table> void reseed_table(Table &table) {
+  using hasher = typename Table::hasher;
+  Table fresh(table.bucket_count(), hasher(random_seed()), table.key_eq(),
+              table.get_allocator());
+  fresh.max_load_factor(table.max_load_factor());
+  while (!table.empty())
+    fresh.insert(table.extract(table.begin()));
+  table.swap(fresh);
+}
+
+template <typename Table> size_t longest_chain(const Table &table) {
+  size_t longest = 0;
+  for (size_t b = 0; b < table.bucket_count(); ++b)
+    longest = std::max(longest, table.bucket_size(b));
+  return longest;
+}
+
+// Per-table state of the guard. A reseed costs O(n), so it is allowed at
+// most once per doubling of the table, which keeps it amortized O(1) per
+// insert. If a reseed does not shorten the longest chain, the keys collide
+// whatever the seed (e.g. a colliding std::hash under seeded_hash's generic
+// path) and the guard gives up on the table.
+struct flood_guard {
+  size_t next_reseed_size = 0;
+  bool futile = false;
+
+  bool may_reseed(size_t size) const noexcept {
+    return !futile && size >= next_reseed_size;
+  }
+
+  template <typename Table> void reseed(Table &table) {
+    size_t before = longest_chain(table);
+    reseed_table(table);
+    futile = longest_chain(table) >= before;
+    next_reseed_size = 2 * table.size();
+  }
+};
+
+// Called after inserting key: reseed if its chain grew too long. Compiles to
+// nothing for hashers that cannot be reseeded.
+template <typename Table>
+void guard_chain(Table &table, const typename Table::key_type &key,
+                 flood_guard &guard) {
+  if constexpr (is_seeded_hash<typename Table::hasher>::value) {
+    if (table.bucket_size(table.bucket(key)) > flood_chain_threshold &&
+        guard.may_reseed(table.size()))
+      guard.reseed(table);
+  }
+}
+
+// Same for bulk inserts, checking every chain
+template <typename Table> void guard_table(Table &table, flood_guard &guard) {
+  if constexpr (is_seeded_hash<typename Table::hasher>::value) {
+    if (guard.may_reseed(table.size()) &&
+        longest_chain(table) > flood_chain_threshold)
+      guard.reseed(table);
+  }
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_FLOOD_GUARD_H
@@ -0,0 +1,94 @@
+#ifndef CONCURRENT_HASH_DIAGNOSTICS_H
+#define CONCURRENT_HASH_DIAGNOSTICS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace concurrent {
+
+/// Health of a hash table, computed from a sample of its buckets. Compare
+/// the observed figures with the expected ones: a poor hash function shows
+/// up as long chains, too many empty buckets and uneven shards.
+struct hash_diagnostics {
+  size_t size = 0;
+  size_t bucket_count = 0;
+  size_t sampled_buckets = 0;
+  double load_factor = 0;
+  double max_load_factor = 0;
+
+  size_t max_chain_length = 0;  // Longest chain (or probe run) sampled
+  double avg_chain_length = 0;  // Mean over non-empty sampled buckets
+  double empty_bucket_fraction = 0;
+  // What a uniform hash would give at this load factor: e^-load_factor
+  double expected_empty_bucket_fraction = 0;
+
+  // Keys of the sampled buckets split into shard_count shards by the low
+  // bits of their hash, as a power-of-two sharded table would: largest shard
+  // divided by the mean. 1.0 is perfectly even.
+  size_t shard_count = 0;
+  double shard_imbalance = 0;
+};
+
+namespace internal {
+
+// Visits at most sample_limit buckets spread evenly over the table, so the
+// cost is bounded regardless of the table size
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+hash_diagnostics
+hash_table_diagnostics(const std::unordered_map<Key, Value, Hash, KeyEqual,
+                                                Allocator> &m,
+                       size_t sample_limit, size_t shard_count) {
+  hash_diagnostics d;
+  d.size = m.size();
+  d.bucket_count = m.bucket_count();
+  d.load_factor = m.load_factor();
+  d.max_load_factor = m.max_load_factor();
+  d.expected_empty_bucket_fraction = std::exp(-d.load_factor);
+  d.shard_count = shard_count ? shard_count : 1;
+
+  if (d.bucket_count == 0)
+    return d;
+  size_t stride =
+      sample_limit && d.bucket_count > sample_limit
+          ? d.bucket_count / sample_limit
+          : 1;
+
+  std::vector<size_t> shards(d.shard_count, 0);
+  size_t empty = 0, non_empty = 0, keys = 0;
+  auto hasher = m.hash_function();
+  for (size_t b = 0; b < d.bucket_count; b += stride) {
+    ++d.sampled_buckets;
+    size_t length = 0;
+    for (auto it = m.begin(b); it != m.end(b); ++it) {
+      ++length;
+      ++shards[hasher(it->first) % d.shard_count];
+    }
+    if (length == 0) {
+      ++empty;
+      continue;
+    }
+    ++non_empty;
+    keys += length;
+    d.max_chain_length = std::max(d.max_chain_length, length);
+  }
+
+  d.empty_bucket_fraction = static_cast<double>(empty) / d.sampled_buckets;
+  d.avg_chain_length =
+      non_empty ? static_cast<double>(keys) / non_empty : 0.0;
+  if (keys) {
+    double mean = static_cast<double>(keys) / d.shard_count;
+    d.shard_imbalance =
+        *std::max_element(shards.begin(), shards.end()) / mean;
+  }
+  return d;
+}
+
+} // namespace internal
+
+} // namespace concurrent
+
+#endif // CONCURRENT_HASH_DIAGNOSTICS_H
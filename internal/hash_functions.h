@@ -0,0 +1,135 @@
+#ifndef CONCURRENT_HASH_FUNCTIONS_H
+#define CONCURRENT_HASH_FUNCTIONS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace concurrent::internal {
+
+// Constants from wyhash (public domain, Wang Yi)
+inline constexpr uint64_t hash_secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+    0x4d5a2da51de1aa47ull};
+
+// 64x64 -> 128 bit multiply, low half in a, high half in b
+inline void multiply_128(uint64_t &a, uint64_t &b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  a = _umul128(a, b, &b);
+#else
+  uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffffu,
+           lb = b & 0xffffffffu;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t carry = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  carry += lo < t;
+  uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+  a = lo;
+  b = hi;
+#endif
+}
+
+// Multiply and fold: the core mixing step of wyhash
+inline uint64_t hash_fold(uint64_t a, uint64_t b) {
+  multiply_128(a, b);
+  return a ^ b;
+}
+
+/// Mix a 64-bit integer so that every input bit affects every output bit
+inline uint64_t hash_mix(uint64_t x, uint64_t seed = 0) {
+  return hash_fold(x ^ seed ^ hash_secret[0], hash_secret[1]);
+}
+
+inline uint64_t read_64(const unsigned char *p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint64_t read_32(const unsigned char *p) {
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+inline uint64_t read_small(const unsigned char *p, size_t len) {
+  return (static_cast<uint64_t>(p[0]) << 16) |
+         (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+/// wyhash (final version 4) of a byte range. Short keys take a handful of
+/// instructions, long ones are consumed 48 bytes per iteration.
+inline uint64_t hash_bytes(const void *key, size_t len, uint64_t seed = 0) {
+  const unsigned char *p = static_cast<const unsigned char *>(key);
+  seed ^= hash_fold(seed ^ hash_secret[0], hash_secret[1]);
+  uint64_t a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (read_32(p) << 32) | read_32(p + ((len >> 3) << 2));
+      b = (read_32(p + len - 4) << 32) |
+          read_32(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = read_small(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = hash_fold(read_64(p) ^ hash_secret[1], read_64(p + 8) ^ seed);
+        see1 = hash_fold(read_64(p + 16) ^ hash_secret[2],
+                         read_64(p + 24) ^ see1);
+        see2 = hash_fold(read_64(p + 32) ^ hash_secret[3],
+                         read_64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = hash_fold(read_64(p) ^ hash_secret[1], read_64(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read_64(p + i - 16);
+    b = read_64(p + i - 8);
+  }
+  a ^= hash_secret[1];
+  b ^= seed;
+  multiply_128(a, b);
+  return hash_fold(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
+
+/// A fresh unpredictable 64-bit seed. The process-wide entropy comes from
+/// std::random_device once; each call then mixes in a counter and the clock
+/// so seeds differ between instances without hitting the device again.
+inline uint64_t random_seed() {
+  static const uint64_t process_entropy = [] {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+  }();
+  static std::atomic<uint64_t> counter{0};
+  uint64_t n = counter.fetch_add(1, std::memory_order_relaxed);
+  uint64_t now = static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  return hash_fold(process_entropy ^ hash_mix(n), now ^ hash_secret[2]);
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_HASH_FUNCTIONS_H
@@ -0,0 +1,253 @@
+#ifndef CONCURRENT_HAZARD_POINTER_H
+#define CONCURRENT_HAZARD_POINTER_H
+
+#include "platform.h"
+#include "thread_registry.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace concurrent::internal {
+
+class hazard_domain;
+
+// Enough for the usual lock-free structures: a stack needs one, a
+// Michael-Scott queue two and a linked list traversal three
+inline constexpr std::size_t hazard_slots_per_thread = 4;
+
+struct hazard_retired {
+  void *ptr;
+  void (*deleter)(void *);
+};
+
+// Per-thread state of a hazard_domain
+struct hazard_record {
+  alignas(cache_line_size) std::atomic<void *> slots[hazard_slots_per_thread];
+  std::atomic<bool> in_use{false};
+  hazard_record *next = nullptr;
+  hazard_domain *owner;
+  unsigned used_slots = 0; // Bit mask, only touched by the owning thread
+  std::vector<hazard_retired> retired;
+
+  inline explicit hazard_record(hazard_domain &domain);
+
+  inline void on_thread_exit();
+};
+
+/// Hazard-pointer memory reclamation.
+///
+/// Before dereferencing a shared pointer a reader publishes it in one of its
+/// hazard slots (hazard_pointer::protect). Writers retire unlinked nodes into
+/// a per-thread list; once that list reaches the scan threshold the thread
+/// collects every published hazard pointer and frees the retired nodes that
+/// are not among them.
+///
+/// Unlike epoch_domain, a stalled reader can only keep the nodes it protects
+/// alive, so the amount of unreclaimed memory stays bounded: at most
+/// scan_threshold nodes per thread plus one per hazard slot.
+class hazard_domain {
+  friend struct hazard_record;
+
+  std::size_t _scan_threshold;
+  std::atomic<std::size_t> _retired{0};
+  std::atomic<std::size_t> _reclaimed{0};
+  std::atomic<std::size_t> _record_count{0};
+  thread_registry<hazard_record, hazard_domain> _records;
+
+  // Nodes left behind by exited threads
+  std::mutex _orphans_mutex;
+  std::vector<hazard_retired> _orphans;
+  std::atomic<bool> _has_orphans{false};
+
+  std::size_t threshold() const {
+    if (_scan_threshold)
+      return _scan_threshold;
+    // Scanning costs O(hazard slots), so scan when there are a multiple of
+    // them to amortize it over
+    std::size_t hazards = _record_count.load(std::memory_order_relaxed) *
+                          hazard_slots_per_thread;
+    return std::max<std::size_t>(64, 2 * hazards);
+  }
+
+  void adopt(std::vector<hazard_retired> &nodes) {
+    if (nodes.empty())
+      return;
+    std::lock_guard<std::mutex> lock(_orphans_mutex);
+    _orphans.insert(_orphans.end(), nodes.begin(), nodes.end());
+    nodes.clear();
+    _has_orphans.store(true, std::memory_order_relaxed);
+  }
+
+  void scan(hazard_record &record) {
+    if (_has_orphans.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(_orphans_mutex);
+      record.retired.insert(record.retired.end(), _orphans.begin(),
+                            _orphans.end());
+      _orphans.clear();
+      _has_orphans.store(false, std::memory_order_relaxed);
+    }
+
+    std::vector<void *> hazards;
+    _records.for_each([&](const hazard_record &r) {
+      for (const auto &slot : r.slots)
+        if (void *p = slot.load(std::memory_order_seq_cst))
+          hazards.push_back(p);
+    });
+    std::sort(hazards.begin(), hazards.end());
+
+    std::size_t kept = 0;
+    for (auto &node : record.retired) {
+      if (std::binary_search(hazards.begin(), hazards.end(), node.ptr))
+        record.retired[kept++] = node;
+      else
+        node.deleter(node.ptr);
+    }
+    std::size_t freed = record.retired.size() - kept;
+    record.retired.resize(kept);
+    _retired.fetch_sub(freed, std::memory_order_relaxed);
+    _reclaimed.fetch_add(freed, std::memory_order_relaxed);
+  }
+
+  std::atomic<void *> &acquire_slot(hazard_record &record) {
+    for (unsigned i = 0; i < hazard_slots_per_thread; ++i) {
+      if (!(record.used_slots & (1u << i))) {
+        record.used_slots |= 1u << i;
+        return record.slots[i];
+      }
+    }
+    throw std::length_error("hazard_domain: out of hazard pointer slots");
+  }
+
+  static void release_slot(hazard_record &record, std::atomic<void *> &slot) {
+    slot.store(nullptr, std::memory_order_release);
+    record.used_slots &= ~(1u << (&slot - record.slots));
+  }
+
+public:
+  /// A hazard pointer owned by the calling thread. While it protects a
+  /// pointer, that node will not be freed by any thread.
+  class hazard_pointer {
+    hazard_record *_record;
+    std::atomic<void *> *_slot;
+
+  public:
+    explicit hazard_pointer(hazard_domain &domain)
+        : _record(&domain._records.local()),
+          _slot(&domain.acquire_slot(*_record)) {}
+
+    hazard_pointer(hazard_pointer &&other) noexcept
+        : _record(other._record), _slot(other._slot) {
+      other._slot = nullptr;
+    }
+    hazard_pointer(const hazard_pointer &) = delete;
+    hazard_pointer &operator=(const hazard_pointer &) = delete;
+    hazard_pointer &operator=(hazard_pointer &&) = delete;
+
+    ~hazard_pointer() {
+      if (_slot)
+        release_slot(*_record, *_slot);
+    }
+
+    /// Load src and protect the result. The returned pointer is safe to
+    /// dereference until the next protect() or reset().
+    template <typename T> T *protect(const std::atomic<T *> &src) {
+      T *ptr = src.load(std::memory_order_relaxed);
+      for (;;) {
+        _slot->store(ptr, std::memory_order_seq_cst);
+        T *current = src.load(std::memory_order_seq_cst);
+        if (current == ptr)
+          return ptr;
+        ptr = current;
+      }
+    }
+
+    /// Protect a pointer the caller has validated by other means
+    void reset(const void *ptr = nullptr) {
+      _slot->store(const_cast<void *>(ptr), std::memory_order_seq_cst);
+    }
+  };
+
+  /// scan_threshold: retired nodes per thread before a scan; 0 scales it with
+  /// the number of hazard slots in use
+  explicit hazard_domain(std::size_t scan_threshold = 0)
+      : _scan_threshold(scan_threshold), _records(*this) {}
+
+  hazard_domain(const hazard_domain &) = delete;
+  hazard_domain &operator=(const hazard_domain &) = delete;
+
+  /// No thread may hold a hazard pointer when the domain is destroyed.
+  /// Everything still retired is freed.
+  ~hazard_domain() {
+    _records.detach();
+    _records.for_each([](hazard_record &r) {
+      for (auto &node : r.retired)
+        node.deleter(node.ptr);
+      r.retired.clear();
+    });
+    for (auto &node : _orphans)
+      node.deleter(node.ptr);
+  }
+
+  /// Process-wide domain for containers that do not need their own
+  static hazard_domain &global() {
+    static hazard_domain domain;
+    return domain;
+  }
+
+  hazard_pointer make_hazard_pointer() { return hazard_pointer(*this); }
+
+  /// Hand over a node that is no longer reachable from the shared structure.
+  /// It is freed by a later scan once no hazard pointer protects it.
+  void retire(void *ptr, void (*deleter)(void *)) {
+    hazard_record &record = _records.local();
+    record.retired.push_back({ptr, deleter});
+    _retired.fetch_add(1, std::memory_order_relaxed);
+    if (record.retired.size() >= threshold())
+      scan(record);
+  }
+
+  template <typename T> void retire(T *ptr) {
+    retire(static_cast<void *>(ptr),
+           [](void *p) { delete static_cast<T *>(p); });
+  }
+
+  /// Scan now instead of waiting for the threshold
+  void reclaim() { scan(_records.local()); }
+
+  /// Nodes retired but not yet freed, across all threads
+  std::size_t retired_count() const {
+    return _retired.load(std::memory_order_relaxed);
+  }
+
+  /// Nodes freed since the domain was created
+  std::size_t reclaimed_count() const {
+    return _reclaimed.load(std::memory_order_relaxed);
+  }
+
+  /// Nodes retired by the calling thread and not yet freed
+  std::size_t local_retired_count() {
+    return _records.local().retired.size();
+  }
+};
+
+inline hazard_record::hazard_record(hazard_domain &domain) : owner(&domain) {
+  for (auto &slot : slots)
+    slot.store(nullptr, std::memory_order_relaxed);
+  domain._record_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void hazard_record::on_thread_exit() {
+  for (auto &slot : slots)
+    slot.store(nullptr, std::memory_order_release);
+  used_slots = 0;
+  owner->adopt(retired);
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_HAZARD_POINTER_H
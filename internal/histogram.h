@@ -0,0 +1,105 @@
+#ifndef CONCURRENT_HISTOGRAM_H
+#define CONCURRENT_HISTOGRAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace concurrent {
+
+/// Latency distribution in nanoseconds with power-of-two buckets: bucket i
+/// counts samples in [2^i, 2^(i+1)), bucket 0 also holds 0.
+struct latency_histogram {
+  static constexpr size_t bucket_count = 40; // Last bucket: >= ~9 minutes
+
+  uint64_t buckets[bucket_count] = {};
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+
+  double mean_ns() const {
+    return count ? static_cast<double>(total_ns) / count : 0.0;
+  }
+
+  /// Upper bound of the bucket holding the p-th quantile, p in [0, 1]
+  uint64_t percentile_ns(double p) const {
+    if (!count)
+      return 0;
+    uint64_t rank = static_cast<uint64_t>(p * (count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+      seen += buckets[i];
+      if (seen >= rank)
+        return std::min<uint64_t>((uint64_t(2) << i) - 1, max_ns);
+    }
+    return max_ns;
+  }
+
+  latency_histogram &operator+=(const latency_histogram &other) {
+    for (size_t i = 0; i < bucket_count; ++i)
+      buckets[i] += other.buckets[i];
+    count += other.count;
+    total_ns += other.total_ns;
+    max_ns = std::max(max_ns, other.max_ns);
+    return *this;
+  }
+};
+
+namespace internal {
+
+using stats_clock = std::chrono::steady_clock;
+
+inline uint64_t elapsed_ns(stats_clock::time_point since,
+                           stats_clock::time_point until) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(until - since)
+          .count());
+}
+
+inline size_t histogram_bucket(uint64_t ns) {
+  size_t bucket = 0;
+  while (ns > 1 && bucket + 1 < latency_histogram::bucket_count) {
+    ns >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+// latency_histogram that can be recorded into from several threads
+class atomic_histogram {
+  std::atomic<uint64_t> _buckets[latency_histogram::bucket_count] = {};
+  std::atomic<uint64_t> _count{0};
+  std::atomic<uint64_t> _total_ns{0};
+  std::atomic<uint64_t> _max_ns{0};
+
+public:
+  void record(uint64_t ns) {
+    _buckets[histogram_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _total_ns.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = _max_ns.load(std::memory_order_relaxed);
+    while (ns > max &&
+           !_max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+      ;
+  }
+
+  /// Add the recorded samples to out. Concurrent recording may make the
+  /// fields slightly inconsistent with each other.
+  void add_to(latency_histogram &out) const {
+    latency_histogram h;
+    for (size_t i = 0; i < latency_histogram::bucket_count; ++i)
+      h.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    h.count = _count.load(std::memory_order_relaxed);
+    h.total_ns = _total_ns.load(std::memory_order_relaxed);
+    h.max_ns = _max_ns.load(std::memory_order_relaxed);
+    out += h;
+  }
+};
+
+} // namespace internal
+
+} // namespace concurrent
+
+#endif // CONCURRENT_HISTOGRAM_H
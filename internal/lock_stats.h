@@ -0,0 +1,105 @@
+#ifndef CONCURRENT_LOCK_STATS_H
+#define CONCURRENT_LOCK_STATS_H
+
+#include "histogram.h"
+#include "striped.h"
+#include <atomic>
+#include <cstdint>
+
+namespace concurrent {
+
+/// Lock statistics for one locking mode (shared or exclusive)
+struct lock_mode_stats {
+  uint64_t acquisitions = 0;
+  uint64_t contended = 0; // Acquisitions that could not take the lock at once
+  latency_histogram wait; // Time spent blocked before getting the lock
+  latency_histogram hold; // Time the lock was held
+};
+
+/// Contention statistics of a container's mutex. Only recorded when the
+/// library is compiled with CONCURRENT_STL_LOCK_STATS defined; otherwise
+/// every field stays zero.
+struct lock_stats {
+#ifdef CONCURRENT_STL_LOCK_STATS
+  static constexpr bool enabled = true;
+#else
+  static constexpr bool enabled = false;
+#endif
+
+  lock_mode_stats shared;
+  lock_mode_stats exclusive;
+};
+
+namespace internal {
+
+class lock_mode_recorder {
+  std::atomic<uint64_t> _contended{0};
+  atomic_histogram _wait;
+  atomic_histogram _hold;
+
+  template <typename Lock> friend class lock_stats_scope;
+
+public:
+  void add_to(lock_mode_stats &out) const {
+    _wait.add_to(out.wait);
+    _hold.add_to(out.hold);
+    out.acquisitions = out.wait.count;
+    out.contended += _contended.load(std::memory_order_relaxed);
+  }
+};
+
+// Recorders are striped per thread so that the statistics do not add a
+// second contended cache line next to the mutex
+class lock_recorder {
+  struct cell {
+    lock_mode_recorder shared;
+    lock_mode_recorder exclusive;
+  };
+
+  striped<cell> _cells;
+
+public:
+  lock_mode_recorder &shared() { return _cells.local().shared; }
+  lock_mode_recorder &exclusive() { return _cells.local().exclusive; }
+
+  lock_stats snapshot() const {
+    lock_stats stats;
+    _cells.for_each([&](const cell &c) {
+      c.shared.add_to(stats.shared);
+      c.exclusive.add_to(stats.exclusive);
+    });
+    return stats;
+  }
+};
+
+// Acquires a deferred lock, timing the wait; records the hold time when it
+// goes out of scope. Declare it after the lock so it is destroyed first.
+template <typename Lock> class lock_stats_scope {
+  lock_mode_recorder &_recorder;
+  stats_clock::time_point _acquired;
+
+public:
+  lock_stats_scope(lock_mode_recorder &recorder, Lock &lock)
+      : _recorder(recorder) {
+    auto start = stats_clock::now();
+    if (!lock.try_lock()) {
+      _recorder._contended.fetch_add(1, std::memory_order_relaxed);
+      lock.lock();
+    }
+    _acquired = stats_clock::now();
+    _recorder._wait.record(elapsed_ns(start, _acquired));
+  }
+
+  lock_stats_scope(const lock_stats_scope &) = delete;
+  lock_stats_scope &operator=(const lock_stats_scope &) = delete;
+
+  ~lock_stats_scope() {
+    _recorder._hold.record(elapsed_ns(_acquired, stats_clock::now()));
+  }
+};
+
+} // namespace internal
+
+} // namespace concurrent
+
+#endif // CONCURRENT_LOCK_STATS_H
@@ -0,0 +1,98 @@
+#ifndef CONCURRENT_MAP_BACKEND_H
+#define CONCURRENT_MAP_BACKEND_H
+
+#include "flat_map.h"
+#include "flood_guard.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace concurrent::internal {
+
+template <typename Hash, typename = void>
+struct is_avalanching_hash : std::false_type {};
+
+template <typename Hash>
+struct is_avalanching_hash<Hash, std::void_t<typename Hash::is_avalanching>>
+    : std::true_type {};
+
+// Integer keys with a well-mixing hash and the default comparator and
+// allocator go to the open-addressed flat_map, if values can be relocated
+// without throwing. Seeded hashes stay on std::unordered_map, whose chains
+// the flood guard watches.
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator,
+          typename Value>
+inline constexpr bool use_flat_map =
+    std::is_integral_v<Key> && !std::is_same_v<Key, bool> &&
+    std::is_nothrow_move_constructible_v<Value> &&
+    is_avalanching_hash<Hash>::value && !is_seeded_hash<Hash>::value &&
+    std::is_same_v<KeyEqual, std::equal_to<Key>> &&
+    std::is_same_v<Allocator, std::allocator<std::pair<const Key, Value>>>;
+
+// std::string keys with such a hash go to flat_map with fingerprinted,
+// inline-key slots. The hash must accept a string_view for lookups.
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator,
+          typename Value>
+inline constexpr bool use_string_flat_map =
+    std::is_same_v<Key, std::string> &&
+    std::is_nothrow_move_constructible_v<Value> &&
+    is_avalanching_hash<Hash>::value && !is_seeded_hash<Hash>::value &&
+    std::is_invocable_r_v<size_t, const Hash &, std::string_view> &&
+    std::is_same_v<KeyEqual, std::equal_to<Key>> &&
+    std::is_same_v<Allocator, std::allocator<std::pair<const Key, Value>>>;
+
+/// Fastest table for Key and Hash: flat_map where the rules above allow it,
+/// std::unordered_map otherwise. Only for tables that never hand out
+/// references to their elements (cache indexes and the like), since a flat
+/// table moves elements on insert and erase.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator, typename = void>
+struct map_backend {
+  using type = std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>;
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+struct map_backend<
+    Key, Value, Hash, KeyEqual, Allocator,
+    std::enable_if_t<use_flat_map<Key, Hash, KeyEqual, Allocator, Value>>> {
+  using type = flat_map<Key, Value, Hash>;
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+struct map_backend<Key, Value, Hash, KeyEqual, Allocator,
+                   std::enable_if_t<use_string_flat_map<Key, Hash, KeyEqual,
+                                                        Allocator, Value>>> {
+  using type = flat_map<Key, Value, Hash, string_slots<Hash>>;
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+using map_backend_t =
+    typename map_backend<Key, Value, Hash, KeyEqual, Allocator>::type;
+
+/// Storage behind concurrent::flat_unordered_map
+template <typename Key, typename Value, typename Hash> struct flat_backend {
+  using allocator_type = std::allocator<std::pair<const Key, Value>>;
+  static_assert(
+      use_flat_map<Key, Hash, std::equal_to<Key>, allocator_type, Value> ||
+          use_string_flat_map<Key, Hash, std::equal_to<Key>, allocator_type,
+                              Value>,
+      "flat_unordered_map needs an integer or std::string key, a value with "
+      "a nothrow move constructor, and an unseeded hash with an "
+      "is_avalanching member type");
+  using type =
+      map_backend_t<Key, Value, Hash, std::equal_to<Key>, allocator_type>;
+};
+
+template <typename Key, typename Value, typename Hash>
+using flat_backend_t = typename flat_backend<Key, Value, Hash>::type;
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_MAP_BACKEND_H
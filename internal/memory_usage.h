@@ -0,0 +1,50 @@
+#ifndef CONCURRENT_MEMORY_USAGE_H
+#define CONCURRENT_MEMORY_USAGE_H
+
+#include <cstddef>
+#include <unordered_map>
+
+namespace concurrent {
+
+/// Estimated heap footprint of a container, in bytes
+struct memory_usage_info {
+  size_t bucket_bytes = 0; // Bucket array / slot index
+  size_t node_bytes = 0;   // Element storage, including per-node overhead
+  size_t value_bytes = 0;  // Out-of-line storage reported by the caller's hook
+
+  size_t total() const { return bucket_bytes + node_bytes + value_bytes; }
+};
+
+namespace internal {
+
+// Heap blocks are rounded up by the allocator; 16 bytes is what glibc malloc
+// and most size-class allocators use
+inline constexpr size_t allocation_granularity = 16;
+
+inline constexpr size_t round_allocation(size_t bytes) {
+  return (bytes + allocation_granularity - 1) / allocation_granularity *
+         allocation_granularity;
+}
+
+// std::unordered_map stores one pointer per bucket and one node per element
+// holding the next pointer, the value and, for non-trivial hashes, the
+// cached hash code. We assume the hash is cached, which overestimates by one
+// word per node for integer keys on libstdc++.
+template <typename Key, typename Value, typename Hash, typename KeyEqual,
+          typename Allocator>
+memory_usage_info
+memory_footprint(const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator> &m) {
+  using value_type = std::pair<const Key, Value>;
+  memory_usage_info info;
+  info.bucket_bytes = round_allocation(m.bucket_count() * sizeof(void *));
+  info.node_bytes =
+      m.size() * round_allocation(sizeof(void *) + sizeof(value_type) +
+                                  sizeof(size_t));
+  return info;
+}
+
+} // namespace internal
+
+} // namespace concurrent
+
+#endif // CONCURRENT_MEMORY_USAGE_H
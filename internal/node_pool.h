@@ -0,0 +1,186 @@
+#ifndef CONCURRENT_NODE_POOL_H
+#define CONCURRENT_NODE_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace concurrent::internal {
+
+// Blocks are handed out in size classes of pool_granularity bytes up to
+// pool_max_block; larger requests go straight to operator new.
+inline constexpr std::size_t pool_granularity = 16;
+inline constexpr std::size_t pool_max_block = 256;
+inline constexpr std::size_t pool_size_classes =
+    pool_max_block / pool_granularity;
+inline constexpr std::size_t pool_slab_size = 64 * 1024;
+// Blocks moved between a thread cache and the central pool at once
+inline constexpr std::size_t pool_batch = 64;
+
+struct pool_block {
+  pool_block *next;
+};
+
+inline constexpr std::size_t pool_size_class(std::size_t bytes) noexcept {
+  return bytes == 0 ? 0 : (bytes - 1) / pool_granularity;
+}
+
+// Shared by all threads: owns the slabs and a free list per size class.
+// Thread caches only come here once per pool_batch allocations.
+class central_pool {
+  struct size_class {
+    std::mutex mutex;
+    pool_block *free = nullptr;
+  };
+
+  size_class _classes[pool_size_classes];
+
+  static pool_block *carve_slab(std::size_t cls) {
+    const std::size_t block_size = (cls + 1) * pool_granularity;
+    char *slab = static_cast<char *>(::operator new(pool_slab_size));
+    pool_block *head = nullptr;
+    for (std::size_t offset = (pool_slab_size / block_size) * block_size;
+         offset >= block_size; offset -= block_size) {
+      auto *block = reinterpret_cast<pool_block *>(slab + offset - block_size);
+      block->next = head;
+      head = block;
+    }
+    return head;
+  }
+
+public:
+  // Never destroyed: nodes of containers with static storage duration may be
+  // freed after every other static object is gone
+  static central_pool &instance() {
+    static central_pool *pool = new central_pool();
+    return *pool;
+  }
+
+  /// Detach up to count blocks; returns how many were taken
+  std::size_t fetch(std::size_t cls, pool_block *&head, std::size_t count) {
+    size_class &c = _classes[cls];
+    std::lock_guard<std::mutex> lock(c.mutex);
+    if (!c.free)
+      c.free = carve_slab(cls);
+    head = c.free;
+    pool_block *tail = c.free;
+    std::size_t taken = 1;
+    while (taken < count && tail->next) {
+      tail = tail->next;
+      ++taken;
+    }
+    c.free = tail->next;
+    tail->next = nullptr;
+    return taken;
+  }
+
+  void give_back(std::size_t cls, pool_block *head, pool_block *tail) {
+    size_class &c = _classes[cls];
+    std::lock_guard<std::mutex> lock(c.mutex);
+    tail->next = c.free;
+    c.free = head;
+  }
+};
+
+// Per-thread free lists; the common allocate/deallocate path takes no lock
+class pool_thread_cache {
+  struct free_list {
+    pool_block *head = nullptr;
+    std::size_t count = 0;
+  };
+
+  free_list _lists[pool_size_classes];
+
+  static bool &destroyed() {
+    // Trivially destructible, so still readable while other thread_local
+    // objects are torn down after this cache
+    thread_local bool flag = false;
+    return flag;
+  }
+
+  // Hand the count least recently freed blocks back to the central pool,
+  // keeping the cache-hot ones at the head of the list
+  void release(std::size_t cls, std::size_t count) {
+    free_list &list = _lists[cls];
+    pool_block *head;
+    if (count == list.count) {
+      head = list.head;
+      list.head = nullptr;
+    } else {
+      pool_block *keep = list.head;
+      for (std::size_t i = 1; i < list.count - count; ++i)
+        keep = keep->next;
+      head = keep->next;
+      keep->next = nullptr;
+    }
+    pool_block *tail = head;
+    while (tail->next)
+      tail = tail->next;
+    list.count -= count;
+    central_pool::instance().give_back(cls, head, tail);
+  }
+
+public:
+  pool_thread_cache() = default;
+  pool_thread_cache(const pool_thread_cache &) = delete;
+  pool_thread_cache &operator=(const pool_thread_cache &) = delete;
+
+  ~pool_thread_cache() {
+    for (std::size_t cls = 0; cls < pool_size_classes; ++cls)
+      if (_lists[cls].count)
+        release(cls, _lists[cls].count);
+    destroyed() = true;
+  }
+
+  void *allocate(std::size_t cls) {
+    free_list &list = _lists[cls];
+    if (!list.head)
+      list.count = central_pool::instance().fetch(cls, list.head, pool_batch);
+    pool_block *block = list.head;
+    list.head = block->next;
+    --list.count;
+    return block;
+  }
+
+  void deallocate(std::size_t cls, void *p) noexcept {
+    free_list &list = _lists[cls];
+    auto *block = static_cast<pool_block *>(p);
+    block->next = list.head;
+    list.head = block;
+    // Keep a batch around for the next allocations, hand the rest back so
+    // memory freed by consumer threads flows back to producers
+    if (++list.count >= 2 * pool_batch)
+      release(cls, pool_batch);
+  }
+
+  /// The calling thread's cache, or nullptr once it has been destroyed
+  static pool_thread_cache *local() {
+    if (destroyed())
+      return nullptr;
+    thread_local pool_thread_cache cache;
+    return &cache;
+  }
+};
+
+inline void *pool_allocate(std::size_t bytes) {
+  const std::size_t cls = pool_size_class(bytes);
+  if (pool_thread_cache *cache = pool_thread_cache::local())
+    return cache->allocate(cls);
+  pool_block *block;
+  central_pool::instance().fetch(cls, block, 1);
+  return block;
+}
+
+inline void pool_deallocate(void *p, std::size_t bytes) noexcept {
+  const std::size_t cls = pool_size_class(bytes);
+  if (pool_thread_cache *cache = pool_thread_cache::local()) {
+    cache->deallocate(cls, p);
+    return;
+  }
+  auto *block = static_cast<pool_block *>(p);
+  central_pool::instance().give_back(cls, block, block);
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_NODE_POOL_H
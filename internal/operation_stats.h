@@ -0,0 +1,119 @@
+#ifndef CONCURRENT_OPERATION_STATS_H
+#define CONCURRENT_OPERATION_STATS_H
+
+#include "histogram.h"
+#include "striped.h"
+#include <atomic>
+#include <cstdint>
+
+namespace concurrent {
+
+/// Per-operation counters and latencies of a container, including time spent
+/// waiting for its lock. Only recorded when compiled with
+/// CONCURRENT_STL_OP_STATS defined; otherwise every field stays zero.
+struct operation_stats {
+#ifdef CONCURRENT_STL_OP_STATS
+  static constexpr bool enabled = true;
+#else
+  static constexpr bool enabled = false;
+#endif
+
+  latency_histogram insert;   // insert, emplace, range insert
+  latency_histogram find;     // find, count, contains
+  latency_histogram erase;    // erase
+  latency_histogram snapshot; // snapshot
+  latency_histogram rehash;   // Operations that grew the table, and
+                              // rehash()/reserve() calls that changed it
+  uint64_t find_hits = 0;
+  uint64_t find_misses = 0;
+
+  uint64_t rehashes() const { return rehash.count; }
+
+  double hit_ratio() const {
+    uint64_t lookups = find_hits + find_misses;
+    return lookups ? static_cast<double>(find_hits) / lookups : 0.0;
+  }
+};
+
+namespace internal {
+
+enum class operation { insert, find, erase, snapshot, rehash };
+
+class operation_recorder {
+  struct cell {
+    atomic_histogram histograms[5];
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+  };
+
+  striped<cell> _cells;
+
+public:
+  // Times one operation from construction to destruction. For
+  // operation::rehash only calls that actually changed the table count.
+  class timer {
+    cell &_cell;
+    operation _op;
+    stats_clock::time_point _start;
+    size_t _buckets = 0;
+    bool _rehashed = false;
+
+  public:
+    timer(operation_recorder &recorder, operation op)
+        : _cell(recorder._cells.local()), _op(op),
+          _start(stats_clock::now()) {}
+
+    timer(const timer &) = delete;
+    timer &operator=(const timer &) = delete;
+
+    // Bracket the work done under the lock to detect rehashes
+    template <typename Table> void before(const Table &table) {
+      _buckets = table.bucket_count();
+    }
+    template <typename Table> void after(const Table &table) {
+      _rehashed = table.bucket_count() != _buckets;
+    }
+
+    void found(bool hit) {
+      (hit ? _cell.hits : _cell.misses)
+          .fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~timer() {
+      uint64_t ns = elapsed_ns(_start, stats_clock::now());
+      if (_op != operation::rehash)
+        _cell.histograms[static_cast<int>(_op)].record(ns);
+      if (_rehashed)
+        _cell.histograms[static_cast<int>(operation::rehash)].record(ns);
+    }
+  };
+
+  operation_stats snapshot() const {
+    operation_stats stats;
+    _cells.for_each([&](const cell &c) {
+      c.histograms[static_cast<int>(operation::insert)].add_to(stats.insert);
+      c.histograms[static_cast<int>(operation::find)].add_to(stats.find);
+      c.histograms[static_cast<int>(operation::erase)].add_to(stats.erase);
+      c.histograms[static_cast<int>(operation::snapshot)].add_to(
+          stats.snapshot);
+      c.histograms[static_cast<int>(operation::rehash)].add_to(stats.rehash);
+      stats.find_hits += c.hits.load(std::memory_order_relaxed);
+      stats.find_misses += c.misses.load(std::memory_order_relaxed);
+    });
+    return stats;
+  }
+};
+
+// Stand-in when statistics are compiled out; every call folds away
+struct null_operation_timer {
+  ~null_operation_timer() {} // Non-trivial: keeps unused-variable warnings off
+  template <typename Table> void before(const Table &) {}
+  template <typename Table> void after(const Table &) {}
+  void found(bool) {}
+};
+
+} // namespace internal
+
+} // namespace concurrent
+
+#endif // CONCURRENT_OPERATION_STATS_H
@@ -0,0 +1,62 @@
+#ifndef CONCURRENT_OPTIMISTIC_LOCK_H
+#define CONCURRENT_OPTIMISTIC_LOCK_H
+
+#include "platform.h"
+#include <atomic>
+#include <cstdint>
+
+namespace concurrent::internal {
+
+/// Version lock for optimistic lock coupling (Leis, Haubenschild and
+/// Neumann, "Optimistic Lock Coupling: A Scalable and Efficient
+/// General-Purpose Synchronization Method"). An odd version means a writer
+/// holds the lock; every unlock moves the version on.
+///
+/// Readers take no lock: they note the version, read the protected data
+/// through relaxed atomics, and check that the version did not change.
+/// Anything read before a failed validate() must be discarded.
+class optimistic_lock {
+  std::atomic<std::uint64_t> _version{0};
+
+public:
+  /// Version to validate against later; waits while a writer is active
+  std::uint64_t read_begin() const noexcept {
+    backoff wait;
+    std::uint64_t version = _version.load(std::memory_order_acquire);
+    while (version & 1) {
+      wait.pause();
+      version = _version.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /// True if nothing was written since read_begin() returned version
+  bool validate(std::uint64_t version) const noexcept {
+    // Keeps the preceding data loads from moving past the version check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return _version.load(std::memory_order_relaxed) == version;
+  }
+
+  /// Turn a read into a write lock; fails if anyone wrote in between
+  bool try_upgrade(std::uint64_t version) noexcept {
+    if (!_version.compare_exchange_strong(version, version + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed))
+      return false;
+    // Keeps the following data stores from becoming visible to a reader
+    // that has not seen the odd version yet
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  void lock() noexcept {
+    while (!try_upgrade(read_begin())) {
+    }
+  }
+
+  void unlock() noexcept { _version.fetch_add(1, std::memory_order_release); }
+};
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_OPTIMISTIC_LOCK_H
@@ -0,0 +1,28 @@
+#ifndef CONCURRENT_PARALLEL_VISIT_H
+#define CONCURRENT_PARALLEL_VISIT_H
+
+#include "../concurrent_thread_pool.h"
+#include <cstddef>
+#include <type_traits>
+
+namespace concurrent::internal {
+
+// Call f on every element of a map backend, split across pool's workers.
+// internal::flat_map keeps its elements in one dense array, which is split
+// by index; node-based maps are split by bucket.
+template <typename Map, typename F>
+void parallel_visit(Map &m, thread_pool &pool, F &&f) {
+  if constexpr (std::is_pointer_v<decltype(m.begin())>) {
+    auto elements = m.begin();
+    pool.parallel_for(0, m.size(), [&](size_t i) { f(elements[i]); });
+  } else {
+    pool.parallel_for(0, m.bucket_count(), [&](size_t bucket) {
+      for (auto it = m.begin(bucket); it != m.end(bucket); ++it)
+        f(*it);
+    });
+  }
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_PARALLEL_VISIT_H
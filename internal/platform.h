@@ -0,0 +1,81 @@
+#ifndef CONCURRENT_PLATFORM_H
+#define CONCURRENT_PLATFORM_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace concurrent::internal {
+
+// Size used to pad data that is written by different threads. We do not rely
+// on std::hardware_destructive_interference_size because it is not available
+// everywhere and GCC warns about its ABI stability.
+inline constexpr std::size_t cache_line_size = 64;
+
+/// Hint to the CPU that we are spinning on a shared location
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+  __yield();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+/// Exponential backoff for retry loops: spin with cpu_relax() for a while,
+/// then start yielding the time slice so a preempted peer can make progress
+class backoff {
+  unsigned _step = 0;
+  static constexpr unsigned spin_limit = 6; // Up to 64 pauses per call
+
+public:
+  void pause() noexcept {
+    if (_step <= spin_limit) {
+      for (unsigned i = 0; i < (1u << _step); ++i)
+        cpu_relax();
+      ++_step;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  void reset() noexcept { _step = 0; }
+
+  /// True once pause() has stopped spinning and yields instead
+  bool yielding() const noexcept { return _step > spin_limit; }
+};
+
+/// Test-and-test-and-set lock for critical sections of a few instructions,
+/// small enough to embed in every node of a structure
+class spinlock {
+  std::atomic<bool> _locked{false};
+
+public:
+  void lock() noexcept {
+    backoff wait;
+    while (_locked.exchange(true, std::memory_order_acquire)) {
+      while (_locked.load(std::memory_order_relaxed))
+        wait.pause();
+    }
+  }
+
+  bool try_lock() noexcept {
+    return !_locked.load(std::memory_order_relaxed) &&
+           !_locked.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() noexcept { _locked.store(false, std::memory_order_release); }
+};
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_PLATFORM_H
@@ -0,0 +1,94 @@
+#ifndef CONCURRENT_SHARDED_H
+#define CONCURRENT_SHARDED_H
+
+#include "platform.h"
+#include "striped.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace concurrent::internal {
+
+/// Fixed power-of-two array of cache-line padded shards, each owning the
+/// keys whose hash selects it. Used by the caches, which bound every shard
+/// separately and lock one shard per operation.
+template <typename Shard> class sharded {
+  struct alignas(cache_line_size) cell {
+    Shard shard;
+  };
+
+  std::unique_ptr<cell[]> _cells;
+  size_t _mask;
+
+public:
+  /// count is rounded up to a power of two
+  explicit sharded(size_t count) {
+    size_t n = 1;
+    while (n < count)
+      n <<= 1;
+    _cells.reset(new cell[n]);
+    _mask = n - 1;
+  }
+
+  size_t size() const noexcept { return _mask + 1; }
+
+  Shard &operator[](size_t index) noexcept { return _cells[index].shard; }
+  const Shard &operator[](size_t index) const noexcept {
+    return _cells[index].shard;
+  }
+
+  /// The table inside a shard indexes by the low bits of the same hash, so
+  /// the shard is picked from multiplied high bits instead
+  Shard &for_hash(size_t hash) noexcept {
+    return (*this)[static_cast<size_t>(
+                       (static_cast<std::uint64_t>(hash) *
+                        0x9e3779b97f4a7c15ull) >>
+                       40) &
+                   _mask];
+  }
+
+  template <typename F> void for_each(F &&f) {
+    for (size_t i = 0; i <= _mask; ++i)
+      f(_cells[i].shard);
+  }
+  template <typename F> void for_each(F &&f) const {
+    for (size_t i = 0; i <= _mask; ++i)
+      f(_cells[i].shard);
+  }
+};
+
+/// Shards for a cache of the given capacity: four per stripe, but not so
+/// many that a shard holds fewer than 16 entries, where per-shard eviction
+/// would stray far from the global order
+inline size_t cache_shard_count(size_t capacity) {
+  size_t shards = 4 * stripe_count();
+  while (shards > 1 && capacity / shards < 16)
+    shards >>= 1;
+  return shards;
+}
+
+/// Shard count for a cache that asked for shards (0 picks
+/// cache_shard_count()): rounded up to a power of two like sharded does, then
+/// halved while there would be more shards than entries
+inline size_t cache_shard_count(size_t capacity, size_t shards) {
+  if (shards == 0)
+    return cache_shard_count(capacity);
+  size_t n = 1;
+  while (n < shards)
+    n <<= 1;
+  while (n > 1 && n > capacity)
+    n >>= 1;
+  return n;
+}
+
+/// Entries shard index may hold so that the shards add up to exactly
+/// capacity: capacity / shards each, and one more for the first
+/// capacity % shards of them. Never 0, so a cache of capacity 0 keeps one.
+inline size_t shard_capacity(size_t capacity, size_t shards, size_t index) {
+  size_t share = capacity / shards + (index < capacity % shards ? 1 : 0);
+  return share ? share : 1;
+}
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_SHARDED_H
@@ -0,0 +1,61 @@
+#ifndef CONCURRENT_STRIPED_H
+#define CONCURRENT_STRIPED_H
+
+#include "platform.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+namespace concurrent::internal {
+
+// Number of stripes: the hardware thread count rounded up to a power of two,
+// capped so that per-container statistics stay small
+inline size_t stripe_count() {
+  static const size_t count = [] {
+    size_t threads = std::thread::hardware_concurrency();
+    size_t n = 1;
+    while (n < threads && n < 64)
+      n <<= 1;
+    return n;
+  }();
+  return count;
+}
+
+// Small dense per-thread index; threads are spread round-robin over stripes
+inline size_t thread_stripe_index() {
+  static std::atomic<size_t> next{0};
+  thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+/// One cache-line padded T per stripe. Each thread writes to its own stripe
+/// (threads share one only when there are more threads than stripes, so T
+/// must still be safe to update concurrently); readers combine all stripes.
+/// Copies and moves start from fresh stripes, like a mutex would.
+template <typename T> class striped {
+  struct alignas(cache_line_size) cell {
+    T value;
+  };
+
+  std::unique_ptr<cell[]> _cells;
+  size_t _mask;
+
+public:
+  striped() : _cells(new cell[stripe_count()]), _mask(stripe_count() - 1) {}
+  striped(const striped &) : striped() {}
+  striped(striped &&) : striped() {}
+  striped &operator=(const striped &) { return *this; }
+  striped &operator=(striped &&) { return *this; }
+
+  T &local() { return _cells[thread_stripe_index() & _mask].value; }
+
+  template <typename Func> void for_each(Func &&func) const {
+    for (size_t i = 0; i <= _mask; ++i)
+      func(_cells[i].value);
+  }
+};
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_STRIPED_H
@@ -0,0 +1,175 @@
+#ifndef CONCURRENT_THREAD_REGISTRY_H
+#define CONCURRENT_THREAD_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace concurrent::internal {
+
+// Ids of the registries that are still alive. A thread that exits after a
+// registry has been destroyed must not touch the records it used to own.
+struct registry_directory {
+  std::mutex mutex;
+  std::unordered_set<std::uint64_t> live;
+  std::atomic<std::uint64_t> next_id{1};
+
+  static registry_directory &instance() {
+    static registry_directory directory;
+    return directory;
+  }
+};
+
+// Per-thread list of the records this thread holds, one per registry.
+// Records are handed back to their registry when the thread exits.
+class thread_cache {
+  struct entry {
+    std::uint64_t id;
+    void *record;
+    void (*release)(void *);
+  };
+
+  std::vector<entry> _entries;
+  std::size_t _last = 0;
+
+public:
+  ~thread_cache() {
+    auto &directory = registry_directory::instance();
+    std::lock_guard<std::mutex> lock(directory.mutex);
+    for (const auto &e : _entries)
+      if (directory.live.count(e.id) > 0)
+        e.release(e.record);
+  }
+
+  void *find(std::uint64_t id) noexcept {
+    if (_last < _entries.size() && _entries[_last].id == id)
+      return _entries[_last].record;
+    for (std::size_t i = 0; i < _entries.size(); ++i) {
+      if (_entries[i].id == id) {
+        _last = i;
+        return _entries[i].record;
+      }
+    }
+    return nullptr;
+  }
+
+  void add(std::uint64_t id, void *record, void (*release)(void *)) {
+    // Threads that outlive many short-lived registries would otherwise keep
+    // collecting entries for dead ids
+    if (_entries.size() >= 16)
+      prune();
+    _entries.push_back({id, record, release});
+    _last = _entries.size() - 1;
+  }
+
+  void prune() {
+    auto &directory = registry_directory::instance();
+    std::lock_guard<std::mutex> lock(directory.mutex);
+    std::vector<entry> alive;
+    for (const auto &e : _entries)
+      if (directory.live.count(e.id) > 0)
+        alive.push_back(e);
+    _entries.swap(alive);
+  }
+
+  static thread_cache &local() {
+    thread_local thread_cache cache;
+    return cache;
+  }
+};
+
+/// Registry of per-thread records owned by a shared object (a reclamation
+/// domain, a statistics block, ...). Each thread gets its own Record on first
+/// use and gives it back on exit; released records are reused by new threads.
+///
+/// Record must be constructible from Owner& and provide:
+///   std::atomic<bool> in_use;  Record *next;  void on_thread_exit();
+/// Records are never freed before the registry itself, so iterating them with
+/// for_each() is always safe.
+template <typename Record, typename Owner> class thread_registry {
+  std::atomic<Record *> _head{nullptr};
+  Owner &_owner;
+  std::uint64_t _id;
+  bool _attached = true;
+
+  static void release(void *p) {
+    auto *record = static_cast<Record *>(p);
+    record->on_thread_exit();
+    record->in_use.store(false, std::memory_order_release);
+  }
+
+  Record *acquire() {
+    for (Record *r = _head.load(std::memory_order_acquire); r; r = r->next) {
+      bool expected = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(expected, true,
+                                            std::memory_order_acq_rel))
+        return r;
+    }
+    auto *r = new Record(_owner);
+    r->in_use.store(true, std::memory_order_relaxed);
+    Record *head = _head.load(std::memory_order_relaxed);
+    do {
+      r->next = head;
+    } while (!_head.compare_exchange_weak(head, r, std::memory_order_release,
+                                          std::memory_order_relaxed));
+    return r;
+  }
+
+public:
+  explicit thread_registry(Owner &owner)
+      : _owner(owner),
+        _id(registry_directory::instance().next_id.fetch_add(
+            1, std::memory_order_relaxed)) {
+    auto &directory = registry_directory::instance();
+    std::lock_guard<std::mutex> lock(directory.mutex);
+    directory.live.insert(_id);
+  }
+
+  thread_registry(const thread_registry &) = delete;
+  thread_registry &operator=(const thread_registry &) = delete;
+
+  ~thread_registry() {
+    detach();
+    Record *r = _head.load(std::memory_order_acquire);
+    while (r) {
+      Record *next = r->next;
+      delete r;
+      r = next;
+    }
+  }
+
+  /// Stop handing records back on thread exit. Owners call this first in
+  /// their destructor so that no exiting thread races with the teardown.
+  void detach() {
+    if (!_attached)
+      return;
+    _attached = false;
+    auto &directory = registry_directory::instance();
+    std::lock_guard<std::mutex> lock(directory.mutex);
+    directory.live.erase(_id);
+  }
+
+  /// The calling thread's record, created on first use
+  Record &local() {
+    auto &cache = thread_cache::local();
+    if (void *r = cache.find(_id))
+      return *static_cast<Record *>(r);
+    Record *r = acquire();
+    cache.add(_id, r, &thread_registry::release);
+    return *r;
+  }
+
+  /// Visit every record ever created, including released ones
+  template <typename Func> void for_each(Func &&func) const {
+    for (Record *r = _head.load(std::memory_order_acquire); r; r = r->next)
+      func(*r);
+  }
+};
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_THREAD_REGISTRY_H
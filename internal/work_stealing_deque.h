@@ -0,0 +1,139 @@
+#ifndef CONCURRENT_WORK_STEALING_DEQUE_H
+#define CONCURRENT_WORK_STEALING_DEQUE_H
+
+#include "platform.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace concurrent::internal {
+
+// Chase-Lev work-stealing deque, with the memory orderings of Lê, Pop, Cohen
+// and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+// Models" (PPoPP 2013).
+//
+// One owner thread pushes and pops at the bottom, LIFO, which keeps a task's
+// children hot in its cache; any other thread steals from the top, FIFO,
+// taking the oldest and usually largest piece of work. Only the last element
+// is ever contended between the owner and thieves.
+//
+// T is stored in atomics and must be trivially copyable (a task pointer).
+template <typename T> class work_stealing_deque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "work_stealing_deque elements must be trivially copyable");
+
+  struct ring {
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> items;
+
+    explicit ring(size_t capacity)
+        : mask(capacity - 1), items(new std::atomic<T>[capacity]) {}
+
+    size_t capacity() const noexcept { return mask + 1; }
+    T get(std::ptrdiff_t i) const noexcept {
+      return items[static_cast<size_t>(i) & mask].load(
+          std::memory_order_relaxed);
+    }
+    void put(std::ptrdiff_t i, T value) noexcept {
+      items[static_cast<size_t>(i) & mask].store(value,
+                                                 std::memory_order_relaxed);
+    }
+  };
+
+  alignas(cache_line_size) std::atomic<std::ptrdiff_t> _top{0};
+  alignas(cache_line_size) std::atomic<std::ptrdiff_t> _bottom{0};
+  std::atomic<ring *> _ring;
+  // Every ring ever used. A thief may still be reading an old one after the
+  // owner grew the deque, so they are only freed with the deque.
+  std::vector<std::unique_ptr<ring>> _rings;
+
+  ring *grow(ring *old, std::ptrdiff_t top, std::ptrdiff_t bottom) {
+    _rings.push_back(std::make_unique<ring>(old->capacity() * 2));
+    ring *bigger = _rings.back().get();
+    for (std::ptrdiff_t i = top; i < bottom; ++i)
+      bigger->put(i, old->get(i));
+    _ring.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+public:
+  explicit work_stealing_deque(size_t capacity = 256) {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    _rings.push_back(std::make_unique<ring>(n));
+    _ring.store(_rings.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(const work_stealing_deque &) = delete;
+  work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+  /// Owner only. Grows instead of failing when full.
+  void push(T value) {
+    std::ptrdiff_t b = _bottom.load(std::memory_order_relaxed);
+    std::ptrdiff_t t = _top.load(std::memory_order_acquire);
+    ring *r = _ring.load(std::memory_order_relaxed);
+    if (b - t > static_cast<std::ptrdiff_t>(r->capacity()) - 1)
+      r = grow(r, t, b);
+    r->put(b, value);
+    // The paper uses a release fence and a relaxed store; a release store is
+    // as cheap on the usual targets and visible to race detectors
+    _bottom.store(b + 1, std::memory_order_release);
+  }
+
+  /// Owner only: the most recently pushed element, if a thief did not take
+  /// it first
+  bool pop(T &out) {
+    std::ptrdiff_t b = _bottom.load(std::memory_order_relaxed) - 1;
+    ring *r = _ring.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::ptrdiff_t t = _top.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    out = r->get(b);
+    if (t == b) {
+      // Last element: race the thieves for it
+      bool won = _top.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /// Any thread: the oldest element. Fails when empty or when it loses a race
+  /// for the element to the owner or another thief.
+  bool steal(T &out) {
+    std::ptrdiff_t t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::ptrdiff_t b = _bottom.load(std::memory_order_acquire);
+    if (t >= b)
+      return false;
+    ring *r = _ring.load(std::memory_order_acquire);
+    T value = r->get(t);
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return false;
+    out = value;
+    return true;
+  }
+
+  /// Only a hint while other threads are using the deque
+  size_t size_approx() const noexcept {
+    std::ptrdiff_t t = _top.load(std::memory_order_relaxed);
+    std::ptrdiff_t b = _bottom.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+  }
+
+  bool empty_approx() const noexcept { return size_approx() == 0; }
+};
+
+} // namespace concurrent::internal
+
+#endif // CONCURRENT_WORK_STEALING_DEQUE_H
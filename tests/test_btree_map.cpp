@@ -0,0 +1,236 @@
+#include "../concurrent_btree_map.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::btree_map<int, int> map;
+  assert(map.empty());
+  assert(!map.find(1).has_value());
+  assert(!map.lower_bound(0).has_value());
+  assert(map.snapshot().empty());
+
+  assert(map.insert(2, 20));
+  assert(map.insert(4, 40));
+  assert(!map.insert(2, 200));
+  assert(map.find(2) == 20);
+  assert(!map.insert_or_assign(2, 200));
+  assert(map.find(2) == 200);
+  assert(map.insert_or_assign(1, 10));
+  assert(map.size() == 3);
+  assert(map.contains(1) && !map.contains(3));
+
+  auto lb = map.lower_bound(3);
+  assert(lb && lb->first == 4 && lb->second == 40);
+  assert(map.lower_bound(1)->first == 1);
+  assert(!map.lower_bound(5).has_value());
+
+  assert(map.erase(2) == 1);
+  assert(map.erase(2) == 0);
+  assert(!map.contains(2));
+  assert(map.size() == 2);
+
+  // Other orderings use the generic in-node search
+  concurrent::btree_map<int, int, std::greater<int>> reversed;
+  for (int i = 0; i < 1000; ++i)
+    reversed.insert(i, i);
+  auto all = reversed.snapshot();
+  bool descending = all.size() == 1000 && all.front().first == 999 &&
+                    all.back().first == 0;
+  assert(descending);
+
+  print_test_status("Single-threaded Basic Ops", descending);
+}
+
+void test_single_threaded_against_std_map() {
+  std::cout << "\n--- Running Randomized Against std::map Test ---"
+            << std::endl;
+  concurrent::btree_map<long, long> map;
+  std::map<long, long> ref;
+  std::mt19937 rng(17);
+
+  // Enough keys for a tree several levels deep
+  for (long i = 0; i < 300000; ++i) {
+    long key = static_cast<long>(rng() % 100000);
+    switch (rng() % 4) {
+    case 0:
+      assert(map.insert(key, i) == ref.emplace(key, i).second);
+      break;
+    case 1:
+      assert(map.insert_or_assign(key, i) ==
+             ref.insert_or_assign(key, i).second);
+      break;
+    case 2:
+      assert(map.erase(key) == ref.erase(key));
+      break;
+    default: {
+      auto it = ref.lower_bound(key);
+      auto lb = map.lower_bound(key);
+      assert(lb.has_value() == (it != ref.end()));
+      if (lb)
+        assert(lb->first == it->first && lb->second == it->second);
+    }
+    }
+    assert(map.size() == ref.size());
+  }
+
+  auto all = map.snapshot();
+  bool same = std::equal(all.begin(), all.end(), ref.begin(), ref.end(),
+                         [](const auto &a, const auto &b) {
+                           return a.first == b.first && a.second == b.second;
+                         });
+  assert(same);
+
+  auto part = map.range(5000, 7000);
+  auto first = ref.lower_bound(5000), last = ref.lower_bound(7000);
+  assert(part.size() == static_cast<size_t>(std::distance(first, last)));
+  for (const auto &pair : part)
+    assert(pair.first >= 5000 && pair.first < 7000 &&
+           ref.at(pair.first) == pair.second);
+
+  // Sequential keys fill the rightmost leaf over and over
+  concurrent::btree_map<unsigned, unsigned> sequential;
+  for (unsigned i = 0; i < 100000; ++i)
+    sequential.insert(i, i);
+  size_t seen = 0;
+  sequential.for_each([&](unsigned key, unsigned value) {
+    assert(key == seen && value == key);
+    ++seen;
+  });
+  same = same && seen == 100000;
+
+  print_test_status("Randomized Against std::map", same);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_writers_and_scans() {
+  std::cout << "\n--- Running Multi-threaded Writers and Scans Test ---"
+            << std::endl;
+  concurrent::btree_map<long, long> map;
+  const int num_writers = 4;
+  const long per_writer = 20000;
+  const long total = num_writers * per_writer;
+  std::atomic<bool> done(false);
+  std::atomic<bool> consistent(true);
+
+  // Readers check that scans come back strictly increasing with matching
+  // values, and that keys below the permanent mark never go missing
+  std::atomic<long> permanent(0);
+  std::vector<std::thread> threads;
+  for (int s = 0; s < 2; ++s)
+    threads.emplace_back([&, s] {
+      std::mt19937 rng(50 + s);
+      while (!done.load()) {
+        long prev = -1;
+        map.for_each_range(0, total, [&](long key, long value) {
+          if (key <= prev || value != key * 2)
+            consistent.store(false);
+          prev = key;
+        });
+        long mark = permanent.load();
+        if (mark > 0) {
+          long key = static_cast<long>(rng() % mark);
+          key -= key % 3 == 1 ? 1 : 0;
+          if (map.find(key) != key * 2)
+            consistent.store(false);
+        }
+      }
+    });
+
+  for (int w = 0; w < num_writers; ++w)
+    threads.emplace_back([&map, w] {
+      std::mt19937 rng(w);
+      for (long i = 0; i < per_writer; ++i) {
+        long key = w + i * num_writers;
+        map.insert(key, key * 2);
+        // Churn on keys of all writers, interleaved with the inserts. Keys
+        // that are 1 mod 3 may be briefly missing.
+        long other = static_cast<long>(rng() % total);
+        if (other % 3 == 1) {
+          map.erase(other);
+          map.insert_or_assign(other, other * 2);
+        }
+      }
+    });
+
+  for (size_t t = 2; t < threads.size(); ++t)
+    threads[t].join();
+  permanent.store(total);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  done.store(true);
+  threads[0].join();
+  threads[1].join();
+
+  bool complete = map.size() == static_cast<size_t>(total);
+  for (long key = 0; complete && key < total; ++key)
+    complete = map.find(key) == key * 2;
+  assert(consistent.load());
+  assert(complete);
+
+  print_test_status("Multi-threaded Writers and Scans",
+                    consistent.load() && complete);
+}
+
+void test_multi_threaded_same_keys() {
+  std::cout << "\n--- Running Multi-threaded Same Keys Test ---" << std::endl;
+  concurrent::btree_map<int, int> map;
+  const int num_threads = 4;
+  const int keys = 512;
+  std::atomic<long> inserted(0), erased(0);
+
+  // Every thread fights over the same few leaves; inserts and erases that
+  // succeed must balance the final size
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(100 + t);
+      for (int i = 0; i < 50000; ++i) {
+        int key = static_cast<int>(rng() % keys);
+        if (rng() % 2)
+          inserted += map.insert(key, key);
+        else
+          erased += static_cast<long>(map.erase(key));
+        auto value = map.find(key);
+        assert(!value || *value == key);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+
+  long expected = inserted.load() - erased.load();
+  bool balanced = static_cast<long>(map.size()) == expected &&
+                  static_cast<long>(map.snapshot().size()) == expected;
+  assert(balanced);
+
+  print_test_status("Multi-threaded Same Keys", balanced);
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_against_std_map();
+
+  // Multi-threaded tests
+  test_multi_threaded_writers_and_scans();
+  test_multi_threaded_same_keys();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,258 @@
+#include "../concurrent_clock_cache.h"
+#include "../concurrent_lru_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::clock_cache<int, std::string> cache(3, 1);
+  assert(cache.empty() && cache.capacity() == 3 && cache.shard_count() == 1);
+  assert(!cache.get(1).has_value());
+
+  assert(cache.put(1, "one"));
+  assert(cache.put(2, "two"));
+  assert(cache.put(3, "three"));
+  assert(!cache.put(3, "THREE"));
+  assert(cache.get(3) == "THREE");
+
+  // 1 and 3 were referenced and get a second chance; 2 goes
+  assert(cache.get(1) == "one");
+  cache.put(4, "four");
+  assert(!cache.contains(2) && cache.contains(1) && cache.contains(3));
+  assert(cache.size() == 3);
+
+  // That sweep cleared 1's bit and stopped at 2, so 3 survives the next
+  // one too; contains() does not set a bit
+  assert(cache.contains(1));
+  cache.put(5, "five");
+  assert(!cache.contains(1) && cache.contains(3) && cache.contains(4));
+  cache.put(6, "six");
+  assert(!cache.contains(4) && cache.contains(3));
+
+  assert(cache.erase(5) == 1 && cache.erase(5) == 0);
+  assert(cache.size() == 2);
+  assert(cache.put(7, "seven") && cache.size() == 3); // Reuses the free slot
+  assert(cache.contains(3) && cache.contains(6));
+  cache.clear();
+  assert(cache.empty() && !cache.get(1).has_value());
+
+  // std::string keys, and a hash that keeps std::unordered_map as the table
+  concurrent::clock_cache<std::string, int> strings(2, 1);
+  concurrent::clock_cache<std::string, int, std::hash<std::string>> chained(2,
+                                                                           1);
+  strings.put("a", 1);
+  strings.put("b", 2);
+  strings.get("a");
+  strings.put("c", 3);
+  chained.put("a", 1);
+  chained.put("b", 2);
+  chained.get("a");
+  chained.put("c", 3);
+  bool passed = strings.contains("a") && !strings.contains("b") &&
+                chained.contains("a") && !chained.contains("b");
+  assert(passed);
+
+  print_test_status("Single-threaded Basic Ops", passed);
+}
+
+// Textbook CLOCK to compare against
+class reference_clock {
+  struct entry {
+    int key;
+    int value;
+    bool referenced;
+  };
+  size_t _capacity;
+  size_t _hand = 0;
+  std::vector<entry> _ring;
+  std::unordered_map<int, size_t> _index;
+
+public:
+  explicit reference_clock(size_t capacity) : _capacity(capacity) {}
+
+  std::optional<int> get(int key) {
+    auto it = _index.find(key);
+    if (it == _index.end())
+      return std::nullopt;
+    _ring[it->second].referenced = true;
+    return _ring[it->second].value;
+  }
+
+  void put(int key, int value) {
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+      _ring[it->second].value = value;
+      _ring[it->second].referenced = true;
+      return;
+    }
+    if (_ring.size() < _capacity) {
+      _index[key] = _ring.size();
+      _ring.push_back({key, value, false});
+      return;
+    }
+    while (_ring[_hand].referenced) {
+      _ring[_hand].referenced = false;
+      _hand = (_hand + 1) % _capacity;
+    }
+    _index.erase(_ring[_hand].key);
+    _ring[_hand] = {key, value, false};
+    _index[key] = _hand;
+    _hand = (_hand + 1) % _capacity;
+  }
+};
+
+void test_single_threaded_against_reference() {
+  std::cout << "\n--- Running Randomized Against Reference CLOCK Test ---"
+            << std::endl;
+  concurrent::clock_cache<int, int> cache(100, 1);
+  reference_clock ref(100);
+  std::mt19937 rng(9);
+
+  bool same = true;
+  for (int i = 0; i < 200000 && same; ++i) {
+    int key = static_cast<int>(rng() % 300);
+    if (rng() % 4 == 0) {
+      cache.put(key, i);
+      ref.put(key, i);
+    } else {
+      same = cache.get(key) == ref.get(key);
+    }
+  }
+  assert(same);
+
+  // With several shards each one is bounded by its share
+  concurrent::clock_cache<int, int> sharded(1000, 8);
+  for (int i = 0; i < 100000; ++i)
+    sharded.put(static_cast<int>(rng() % 100000), i);
+  bool bounded = sharded.size() <= 1000 && sharded.size() > 900;
+
+  // Capacities that do not divide evenly, or smaller than the shard count,
+  // still bound the whole cache
+  concurrent::clock_cache<int, int> uneven(17, 16);
+  concurrent::clock_cache<int, int> tiny(3, 16);
+  for (int i = 0; i < 10000; ++i) {
+    uneven.put(i, i);
+    tiny.put(i, i);
+  }
+  bounded = bounded && uneven.size() <= 17 && tiny.size() <= 3;
+  assert(bounded);
+
+  print_test_status("Randomized Against Reference CLOCK", same && bounded);
+}
+
+void test_single_threaded_hit_ratio() {
+  std::cout << "\n--- Running Single-threaded Hit Ratio Test ---" << std::endl;
+  // Zipf-distributed keys, cache holding 5% of them: CLOCK should stay
+  // close to LRU
+  const int keys = 20000;
+  std::vector<double> cdf(keys);
+  double sum = 0;
+  for (int i = 0; i < keys; ++i)
+    cdf[i] = sum += 1.0 / std::pow(i + 1.0, 0.99);
+  std::mt19937_64 rng(21);
+  std::uniform_real_distribution<double> uniform(0.0, sum);
+
+  concurrent::clock_cache<int, int> clock(keys / 20);
+  concurrent::lru_cache<int, int> lru(keys / 20);
+  long clock_hits = 0, lru_hits = 0;
+  const int ops = 200000;
+  for (int i = 0; i < ops; ++i) {
+    int key = static_cast<int>(
+        std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+    if (clock.get(key))
+      ++clock_hits;
+    else
+      clock.put(key, key);
+    if (lru.get(key))
+      ++lru_hits;
+    else
+      lru.put(key, key);
+  }
+  double clock_ratio = static_cast<double>(clock_hits) / ops;
+  double lru_ratio = static_cast<double>(lru_hits) / ops;
+  std::cout << "hit ratio: clock " << clock_ratio << ", lru " << lru_ratio
+            << std::endl;
+  bool close = clock_ratio > lru_ratio - 0.05;
+  assert(close);
+
+  print_test_status("Single-threaded Hit Ratio", close);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_hits_and_puts() {
+  std::cout << "\n--- Running Multi-threaded Hits and Puts Test ---"
+            << std::endl;
+  const size_t capacity = 2000;
+  concurrent::clock_cache<long, long> cache(capacity);
+  const int num_threads = 4;
+  std::atomic<bool> consistent(true);
+  std::atomic<long> hits(0);
+
+  // Values are always key * 3, whoever put them; readers must never see
+  // anything else, and a skewed key distribution must mostly hit
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      long local_hits = 0;
+      for (int i = 0; i < 100000; ++i) {
+        long key = static_cast<long>(rng() % 1000);
+        if (rng() % 8 == 0)
+          key += static_cast<long>(rng() % 100000); // Cold keys
+        if (auto value = cache.get(key)) {
+          ++local_hits;
+          if (*value != key * 3)
+            consistent.store(false);
+        } else {
+          cache.put(key, key * 3);
+        }
+        if (i % 1000 == 0)
+          cache.erase(static_cast<long>(rng() % 1000));
+      }
+      hits += local_hits;
+    });
+  for (auto &t : threads)
+    t.join();
+
+  size_t per_shard = (capacity + cache.shard_count() - 1) / cache.shard_count();
+  bool bounded = cache.size() <= per_shard * cache.shard_count();
+  bool warm = hits.load() > num_threads * 100000 / 2;
+  assert(consistent.load());
+  assert(bounded);
+  assert(warm);
+
+  print_test_status("Multi-threaded Hits and Puts",
+                    consistent.load() && bounded && warm);
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_against_reference();
+  test_single_threaded_hit_ratio();
+
+  // Multi-threaded tests
+  test_multi_threaded_hits_and_puts();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+// Lock statistics show which path each update took
+#ifndef CONCURRENT_STL_LOCK_STATS
+#define CONCURRENT_STL_LOCK_STATS
+#endif
+#include "../concurrent_counter_map.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::counter_map<std::string> counters;
+
+  assert(counters.empty());
+  assert(!counters.find("a").has_value());
+  assert(counters.get("a") == 0);
+
+  assert(counters.increment("a") == 1);
+  assert(counters.add("a", 10) == 11);
+  assert(counters.decrement("a") == 10);
+  assert(counters.add("b", -5) == -5);
+  assert(counters.size() == 2);
+  assert(counters.get("a") == 10);
+  assert(counters.find("b").value() == -5);
+  assert(counters.contains("b"));
+  assert(counters.total() == 5);
+
+  // reset() returns the old value and keeps the key
+  assert(counters.reset("a") == 10);
+  assert(counters.get("a") == 0);
+  assert(counters.contains("a"));
+  assert(counters.reset("missing") == 0);
+  assert(!counters.contains("missing"));
+
+  auto snap = counters.snapshot();
+  std::sort(snap.begin(), snap.end());
+  assert(snap.size() == 2);
+  assert(snap[0].first == "a" && snap[0].second == 0);
+  assert(snap[1].first == "b" && snap[1].second == -5);
+
+  assert(counters.erase("b") == 1);
+  assert(!counters.contains("b"));
+  counters.clear();
+  assert(counters.empty());
+
+  print_test_status("Single-threaded Basic Ops", counters.empty());
+}
+
+void test_single_threaded_lock_paths() {
+  std::cout << "\n--- Running Single-threaded Lock Paths Test ---"
+            << std::endl;
+  concurrent::counter_map<int, unsigned> counters;
+
+  for (int round = 0; round < 10; ++round)
+    for (int key = 0; key < 5; ++key)
+      counters.increment(key);
+
+  // Only the first update of each key inserted under the exclusive lock
+  concurrent::lock_stats stats = counters.stats();
+  assert(stats.exclusive.acquisitions == 5);
+  assert(stats.shared.acquisitions == 50);
+  for (int key = 0; key < 5; ++key)
+    assert(counters.get(key) == 10);
+
+  print_test_status("Single-threaded Lock Paths",
+                    stats.exclusive.acquisitions == 5);
+}
+
+void test_single_threaded_striped() {
+  std::cout << "\n--- Running Single-threaded Striped Test ---" << std::endl;
+  concurrent::counter_map<std::string> counters;
+
+  counters.add("hot", 5);
+  counters.stripe("hot");
+  counters.stripe("new");
+  assert(counters.is_striped("hot"));
+  assert(counters.is_striped("new"));
+  assert(!counters.is_striped("missing"));
+
+  // The value from before striping is kept; striped adds return no value
+  assert(!counters.add("hot", 3));
+  assert(counters.get("hot") == 8);
+  assert(counters.get("new") == 0);
+  counters.decrement("new");
+  assert(counters.get("new") == -1);
+  assert(counters.total() == 7);
+
+  assert(counters.reset("hot") == 8);
+  assert(counters.get("hot") == 0);
+  assert(counters.is_striped("hot"));
+
+  // Striping again returns a handle to the same stripes
+  concurrent::hot_counter<long> handle = counters.stripe("hot");
+  handle.add(4);
+  counters.stripe("hot").decrement();
+  assert(counters.get("hot") == 3);
+  counters.reset("hot");
+
+  print_test_status("Single-threaded Striped", counters.get("hot") == 0);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_increments() {
+  std::cout << "\n--- Running Multi-threaded Increments Test ---" << std::endl;
+  concurrent::counter_map<int, long> counters;
+  const int num_threads = 8;
+  const int increments = 20000;
+  const int num_keys = 16;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&counters, t] {
+      for (int i = 0; i < increments; ++i)
+        counters.add((i + t) % num_keys, 2);
+    });
+  }
+  // Readers see monotonically growing counters while the writers run
+  std::thread reader([&counters] {
+    long last = 0;
+    for (int i = 0; i < 1000; ++i) {
+      long now = counters.total();
+      assert(now >= last);
+      last = now;
+    }
+  });
+  for (auto &th : threads)
+    th.join();
+  reader.join();
+
+  long expected = 2L * num_threads * increments;
+  assert(counters.total() == expected);
+  for (int key = 0; key < num_keys; ++key)
+    assert(counters.get(key) == expected / num_keys);
+  assert(counters.stats().exclusive.acquisitions <=
+         static_cast<uint64_t>(num_keys * num_threads));
+
+  print_test_status("Multi-threaded Increments", counters.total() == expected);
+}
+
+void test_multi_threaded_hot_key() {
+  std::cout << "\n--- Running Multi-threaded Hot Key Test ---" << std::endl;
+  concurrent::counter_map<int, long> counters;
+  concurrent::hot_counter<long> hot = counters.stripe(0);
+  const int num_threads = 16;
+  const int increments = 10000;
+
+  // Resets drain the counter while it is being incremented; nothing is lost
+  std::atomic<long> drained(0);
+  std::atomic<bool> done(false);
+  std::thread drainer([&] {
+    while (!done.load())
+      drained.fetch_add(counters.reset(0));
+  });
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&counters, &hot, t] {
+      // Half the threads go through the map, half use the handle
+      for (int i = 0; i < increments; ++i) {
+        if (t % 2)
+          counters.increment(0);
+        else
+          hot.increment();
+      }
+    });
+  for (auto &th : threads)
+    th.join();
+  done.store(true);
+  drainer.join();
+
+  long expected = static_cast<long>(num_threads) * increments;
+  long seen = drained.load() + counters.get(0);
+  assert(seen == expected);
+
+  print_test_status("Multi-threaded Hot Key", seen == expected);
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_lock_paths();
+  test_single_threaded_striped();
+
+  // Multi-threaded tests
+  test_multi_threaded_increments();
+  test_multi_threaded_hot_key();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
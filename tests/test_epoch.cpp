@@ -0,0 +1,178 @@
+#include "../internal/epoch.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+std::atomic<int> live_nodes(0);
+
+struct tracked_node {
+  static constexpr int alive_marker = 0x5a5a5a5a;
+  int value;
+  int marker = alive_marker;
+
+  explicit tracked_node(int v) : value(v) { live_nodes.fetch_add(1); }
+  ~tracked_node() {
+    marker = 0;
+    live_nodes.fetch_sub(1);
+  }
+};
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_retire_and_collect() {
+  std::cout << "\n--- Running Single-threaded Retire Test ---" << std::endl;
+  {
+    concurrent::internal::epoch_domain domain(1000);
+
+    for (int i = 0; i < 10; ++i)
+      domain.retire(new tracked_node(i));
+    assert(domain.pending() == 10);
+    assert(live_nodes.load() == 10);
+
+    // Two epoch advances are required before anything becomes reclaimable
+    for (int i = 0; i < 3; ++i)
+      domain.collect();
+    assert(domain.pending() == 0);
+    assert(live_nodes.load() == 0);
+
+    // Whatever is left in limbo is freed by the destructor
+    domain.retire(new tracked_node(42));
+    assert(live_nodes.load() == 1);
+  }
+  assert(live_nodes.load() == 0);
+
+  print_test_status("Single-threaded Retire", live_nodes.load() == 0);
+}
+
+void test_single_threaded_nested_pin() {
+  std::cout << "\n--- Running Single-threaded Nested Pin Test ---"
+            << std::endl;
+  concurrent::internal::epoch_domain domain;
+
+  std::uint64_t before = domain.epoch();
+  {
+    auto outer = domain.pin();
+    {
+      auto inner = domain.pin();
+    }
+    // Still pinned through the outer guard: we are pinned at the current
+    // epoch, so it can advance at most once
+    for (int i = 0; i < 3; ++i)
+      domain.collect();
+    assert(domain.epoch() <= before + 1);
+  }
+  for (int i = 0; i < 3; ++i)
+    domain.collect();
+  assert(domain.epoch() > before + 1);
+
+  print_test_status("Single-threaded Nested Pin", true);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_pinned_reader_blocks_reclamation() {
+  std::cout << "\n--- Running Multi-threaded Pinned Reader Test ---"
+            << std::endl;
+  concurrent::internal::epoch_domain domain(1);
+  std::atomic<tracked_node *> shared(new tracked_node(1));
+  std::atomic<bool> pinned(false);
+  std::atomic<bool> release(false);
+  std::atomic<int> observed(0);
+
+  std::thread reader([&]() {
+    auto guard = domain.pin();
+    tracked_node *node = shared.load();
+    pinned.store(true);
+    while (!release.load())
+      std::this_thread::yield();
+    observed.store(node->marker == tracked_node::alive_marker ? node->value
+                                                              : -1);
+  });
+
+  while (!pinned.load())
+    std::this_thread::yield();
+
+  tracked_node *old = shared.exchange(new tracked_node(2));
+  domain.retire(old);
+  for (int i = 0; i < 5; ++i)
+    domain.collect();
+  bool still_alive = live_nodes.load() == 2;
+  assert(still_alive);
+
+  release.store(true);
+  reader.join();
+  assert(observed.load() == 1);
+
+  for (int i = 0; i < 3; ++i)
+    domain.collect();
+  assert(live_nodes.load() == 1);
+  delete shared.load();
+
+  print_test_status("Multi-threaded Pinned Reader",
+                    still_alive && observed.load() == 1);
+}
+
+void test_multi_threaded_swap_and_read() {
+  std::cout << "\n--- Running Multi-threaded Swap And Read Test ---"
+            << std::endl;
+  std::atomic<bool> corrupted(false);
+  {
+    concurrent::internal::epoch_domain domain(16);
+    std::atomic<tracked_node *> shared(new tracked_node(0));
+    const int num_writers = 2;
+    const int num_readers = 4;
+    const int ops_per_thread = 20000;
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < num_writers; ++w) {
+      threads.emplace_back([&, w]() {
+        for (int i = 0; i < ops_per_thread; ++i) {
+          tracked_node *old = shared.exchange(new tracked_node(w));
+          domain.retire(old);
+        }
+      });
+    }
+    for (int r = 0; r < num_readers; ++r) {
+      threads.emplace_back([&]() {
+        for (int i = 0; i < ops_per_thread; ++i) {
+          auto guard = domain.pin();
+          tracked_node *node = shared.load();
+          if (node->marker != tracked_node::alive_marker)
+            corrupted.store(true);
+        }
+      });
+    }
+    for (auto &t : threads)
+      t.join();
+
+    assert(!corrupted.load());
+    delete shared.load();
+  }
+  // Exited threads hand their limbo lists to the domain, which frees them
+  assert(live_nodes.load() == 0);
+
+  print_test_status("Multi-threaded Swap And Read",
+                    !corrupted.load() && live_nodes.load() == 0);
+}
+
+int main() {
+  test_single_threaded_retire_and_collect();
+  test_single_threaded_nested_pin();
+
+  // Multi-threaded tests
+  test_multi_threaded_pinned_reader_blocks_reclamation();
+  test_multi_threaded_swap_and_read();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
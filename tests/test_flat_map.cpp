@@ -0,0 +1,378 @@
+#include "../concurrent_hash.h"
+#include "../concurrent_unordered_map.h"
+#include "../internal/flat_map.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+using flat = concurrent::internal::flat_map<uint64_t, std::string,
+                                            concurrent::hash<uint64_t>>;
+
+// Few distinct hashes, so different keys often share a fingerprint and the
+// inline bytes or the key itself have to decide
+struct colliding_string_hash {
+  using is_avalanching = void;
+  size_t operator()(std::string_view s) const {
+    return concurrent::hash<std::string_view>()(s) & 0x7;
+  }
+};
+
+template <typename Hash>
+using string_flat =
+    concurrent::internal::flat_map<std::string, int, Hash,
+                                   concurrent::internal::string_slots<Hash>>;
+
+// --- Single-threaded Tests ---
+
+void test_backend_selection() {
+  std::cout << "\n--- Running Backend Selection Test ---" << std::endl;
+  using concurrent::internal::flat_map;
+  // The flat table is opt-in: unordered_map keeps std::unordered_map
+  static_assert(
+      std::is_same_v<concurrent::unordered_map<uint64_t, int>::container_type,
+                     std::unordered_map<uint64_t, int,
+                                        concurrent::hash<uint64_t>>>);
+  static_assert(std::is_same_v<
+                concurrent::unordered_map<std::string, int>::container_type,
+                std::unordered_map<std::string, int,
+                                   concurrent::hash<std::string>>>);
+  static_assert(std::is_same_v<
+                concurrent::flat_unordered_map<uint64_t, int>::container_type,
+                flat_map<uint64_t, int, concurrent::hash<uint64_t>>>);
+  static_assert(
+      std::is_same_v<concurrent::flat_unordered_map<int, int>::container_type,
+                     flat_map<int, int, concurrent::hash<int>>>);
+  using string_map = concurrent::flat_unordered_map<std::string, int>;
+  static_assert(std::is_same_v<
+                string_map::container_type,
+                flat_map<std::string, int, concurrent::hash<std::string>,
+                         concurrent::internal::string_slots<
+                             concurrent::hash<std::string>>>>);
+
+  // Internal tables pick the flat one on their own, except for hashes that
+  // may not mix and seeded hashes
+  using concurrent::internal::map_backend_t;
+  static_assert(std::is_same_v<
+                map_backend_t<int, int, concurrent::hash<int>,
+                              std::equal_to<int>,
+                              std::allocator<std::pair<const int, int>>>,
+                flat_map<int, int, concurrent::hash<int>>>);
+  static_assert(std::is_same_v<
+                map_backend_t<int, int, std::hash<int>, std::equal_to<int>,
+                              std::allocator<std::pair<const int, int>>>,
+                std::unordered_map<int, int, std::hash<int>>>);
+  static_assert(std::is_same_v<
+                map_backend_t<int, int, concurrent::seeded_hash<int>,
+                              std::equal_to<int>,
+                              std::allocator<std::pair<const int, int>>>,
+                std::unordered_map<int, int, concurrent::seeded_hash<int>>>);
+
+  print_test_status("Backend Selection", true);
+}
+
+void test_basic_ops() {
+  std::cout << "\n--- Running Basic Ops Test ---" << std::endl;
+  flat m;
+  assert(m.empty());
+  assert(m.find(1) == m.end());
+
+  assert(m.insert({1, "one"}).second);
+  assert(!m.insert({1, "uno"}).second);
+  assert(m.at(1) == "one");
+  m.insert_or_assign(1, std::string("uno"));
+  assert(m.at(1) == "uno");
+  assert(m.emplace(2, "two").second);
+  m[3] = "three";
+  assert(m.size() == 3);
+  assert(m.count(2) == 1 && m.count(4) == 0);
+
+  bool threw = false;
+  try {
+    m.at(4);
+  } catch (const std::out_of_range &) {
+    threw = true;
+  }
+  assert(threw);
+
+  assert(m.erase(2) == 1);
+  assert(m.erase(2) == 0);
+  assert(m.size() == 2);
+  assert(m.find(2) == m.end());
+  assert(m.find(3)->second == "three");
+
+  // The key used to mark empty slots is still a valid key
+  const uint64_t max = std::numeric_limits<uint64_t>::max();
+  m[max] = "max";
+  assert(m.size() == 3);
+  assert(m.at(max) == "max");
+  m.rehash(1024);
+  assert(m.at(max) == "max");
+  assert(m.erase(1) == 1);
+  assert(m.at(max) == "max");
+  assert(m.erase(max) == 1);
+  assert(m.find(max) == m.end());
+
+  m.clear();
+  assert(m.empty());
+  assert(m.find(3) == m.end());
+
+  print_test_status("Basic Ops", m.empty());
+}
+
+void test_against_std() {
+  std::cout << "\n--- Running Randomized Against std::unordered_map Test ---"
+            << std::endl;
+  flat m;
+  std::unordered_map<uint64_t, std::string> ref;
+  std::mt19937_64 rng(42);
+
+  // A small key space forces long probe runs, collisions and many erases
+  // through backward shifting
+  for (int i = 0; i < 200000; ++i) {
+    uint64_t key = rng() % 512;
+    if (i % 1000 == 0)
+      key = std::numeric_limits<uint64_t>::max();
+    switch (rng() % 3) {
+    case 0:
+      m[key] = std::to_string(i);
+      ref[key] = std::to_string(i);
+      break;
+    case 1:
+      assert(m.erase(key) == ref.erase(key));
+      break;
+    default: {
+      auto it = m.find(key);
+      auto rit = ref.find(key);
+      assert((it == m.end()) == (rit == ref.end()));
+      if (it != m.end())
+        assert(it->second == rit->second);
+    }
+    }
+    assert(m.size() == ref.size());
+    assert(m.load_factor() <= m.max_load_factor());
+  }
+
+  size_t visited = 0;
+  for (const auto &pair : m) {
+    assert(ref.at(pair.first) == pair.second);
+    ++visited;
+  }
+  assert(visited == ref.size());
+
+  print_test_status("Randomized Against std::unordered_map",
+                    visited == ref.size());
+}
+
+void test_copy_move_erase_iteration() {
+  std::cout << "\n--- Running Copy, Move and Erase Iteration Test ---"
+            << std::endl;
+  flat m;
+  for (uint64_t i = 0; i < 1000; ++i)
+    m[i] = std::to_string(i);
+
+  flat copy = m;
+  flat moved = std::move(m);
+  assert(copy.size() == 1000 && moved.size() == 1000);
+  assert(m.empty());
+  m[7] = "seven";
+  assert(m.size() == 1);
+
+  // Erasing while iterating visits every element once
+  for (auto it = moved.begin(); it != moved.end();) {
+    if (it->first % 2 == 0)
+      it = moved.erase(it);
+    else
+      ++it;
+  }
+  assert(moved.size() == 500);
+  for (uint64_t i = 0; i < 1000; ++i)
+    assert(moved.count(i) == i % 2);
+  assert(copy.at(500) == "500");
+
+  copy = moved;
+  assert(copy.size() == 500);
+  copy.reserve(100000);
+  assert(copy.bucket_count() >= 100000);
+  assert(copy.at(501) == "501");
+
+  print_test_status("Copy, Move and Erase Iteration", moved.size() == 500);
+}
+
+// Counts how it is copied and moved
+struct tracked {
+  static inline size_t copies = 0;
+  static inline size_t moves = 0;
+  int value = 0;
+
+  tracked(int v) : value(v) {}
+  tracked(const tracked &other) : value(other.value) { ++copies; }
+  tracked(tracked &&other) noexcept : value(other.value) { ++moves; }
+  tracked &operator=(const tracked &) = default;
+  tracked &operator=(tracked &&) = default;
+};
+
+void test_relocation() {
+  std::cout << "\n--- Running Relocation Test ---" << std::endl;
+  // Growth and erase move elements, string keys included, never copy them
+  using string_hash = concurrent::hash<std::string>;
+  using string_slots = concurrent::internal::string_slots<string_hash>;
+  concurrent::internal::flat_map<std::string, tracked, string_hash,
+                                 string_slots>
+      m;
+  m.emplace(std::string(40, 'k'), 0); // Warm up the static counters
+  tracked::copies = tracked::moves = 0;
+  for (int i = 1; i < 100000; ++i)
+    m.emplace(std::string(40, 'k') + std::to_string(i), i);
+  for (int i = 1; i < 100000; i += 2)
+    m.erase(std::string(40, 'k') + std::to_string(i));
+  bool moved_only = tracked::copies == 0 && tracked::moves > 0;
+  assert(moved_only);
+  assert(m.size() == 50000);
+  assert(m.at(std::string(40, 'k') + "99998").value == 99998);
+
+  // A duplicate emplace leaves the table as it was, even when full
+  concurrent::internal::flat_map<int, tracked, concurrent::hash<int>> full;
+  while (full.size() < full.value_capacity() || full.empty())
+    full.emplace(static_cast<int>(full.size()), 0);
+  size_t capacity = full.value_capacity();
+  size_t buckets = full.bucket_count();
+  const tracked *first = &full.at(0);
+  assert(!full.emplace(0, 1).second);
+  bool unchanged = full.value_capacity() == capacity &&
+                   full.bucket_count() == buckets && &full.at(0) == first &&
+                   full.at(0).value == 0;
+  assert(unchanged);
+
+  print_test_status("Relocation", moved_only && unchanged);
+}
+
+template <typename Hash> bool check_string_keys() {
+  string_flat<Hash> m;
+  std::unordered_map<std::string, int> ref;
+  std::mt19937 rng(7);
+
+  // Lengths on both sides of the inline limit, sharing long prefixes
+  for (int i = 0; i < 50000; ++i) {
+    size_t len = rng() % 40;
+    std::string key = "/api/v1/" + std::string(len, 'a' + rng() % 3);
+    key.resize(rng() % (key.size() + 1));
+    switch (rng() % 3) {
+    case 0:
+      m[key] = i;
+      ref[key] = i;
+      break;
+    case 1:
+      assert(m.erase(key) == ref.erase(key));
+      break;
+    default: {
+      auto it = m.find(std::string_view(key));
+      auto rit = ref.find(key);
+      assert((it == m.end()) == (rit == ref.end()));
+      if (it != m.end())
+        assert(it->second == rit->second);
+    }
+    }
+    assert(m.size() == ref.size());
+  }
+
+  for (const auto &pair : ref)
+    assert(m.at(pair.first) == pair.second);
+  return m.size() == ref.size();
+}
+
+void test_string_keys() {
+  std::cout << "\n--- Running String Keys Test ---" << std::endl;
+  string_flat<concurrent::hash<std::string>> m;
+  std::string long_key(100, 'x');
+
+  assert(m.emplace("short", 1).second);
+  assert(m.emplace(long_key, 2).second);
+  assert(!m.emplace("short", 3).second);
+  assert(m.insert({"", 4}).second);
+  assert(m.at("short") == 1);
+  assert(m.at(long_key) == 2);
+  assert(m.at("") == 4);
+  assert(m.count(std::string_view("shor")) == 0);
+  assert(m.count(long_key.substr(1)) == 0);
+
+  // Moved-in keys are not copied
+  std::string moved(64, 'm');
+  m.insert_or_assign(std::move(moved), 5);
+  assert(m.at(std::string(64, 'm')) == 5);
+
+  bool ok = check_string_keys<concurrent::hash<std::string>>() &&
+            check_string_keys<colliding_string_hash>();
+  assert(ok);
+
+  concurrent::flat_unordered_map<std::string, int> map;
+  map.insert("/index.html", 1);
+  map.insert(std::string("/a/rather/long/path/to/a/resource"), 2);
+  assert(map.find("/index.html") == 1);
+  assert(map.find("/a/rather/long/path/to/a/resource") == 2);
+  assert(!map.find("/missing").has_value());
+
+  print_test_status("String Keys", ok);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_through_map() {
+  std::cout
+      << "\n--- Running Multi-threaded Through flat_unordered_map Test ---"
+      << std::endl;
+  concurrent::flat_unordered_map<uint64_t, uint64_t> map;
+  const int num_threads = 4;
+  const uint64_t per_thread = 5000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&map, t, per_thread] {
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        uint64_t key = t * per_thread + i;
+        map.insert(key, key * 2);
+        assert(map.find(key) == key * 2);
+        if (i % 3 == 0)
+          map.erase(key);
+      }
+    });
+  }
+  for (auto &th : threads)
+    th.join();
+
+  size_t expected = num_threads * (per_thread - (per_thread + 2) / 3);
+  assert(map.size() == expected);
+  for (uint64_t key = 0; key < num_threads * per_thread; ++key)
+    assert(map.find(key).has_value() == ((key % per_thread) % 3 != 0));
+
+  print_test_status("Multi-threaded Through flat_unordered_map",
+                    map.size() == expected);
+}
+
+int main() {
+  test_backend_selection();
+  test_basic_ops();
+  test_against_std();
+  test_copy_move_erase_iteration();
+  test_relocation();
+  test_string_keys();
+
+  // Multi-threaded tests
+  test_multi_threaded_through_map();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
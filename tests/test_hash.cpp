@@ -0,0 +1,139 @@
+#include "../concurrent_hash.h"
+
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_integer_low_bits() {
+  std::cout << "\n--- Running Integer Low Bits Test ---" << std::endl;
+  concurrent::hash<uint64_t> h;
+
+  // Keys with a common stride must still fill power-of-two buckets evenly
+  const size_t buckets = 1024;
+  const uint64_t num_keys = 64 * buckets;
+  std::vector<size_t> counts(buckets, 0);
+  for (uint64_t i = 0; i < num_keys; ++i)
+    ++counts[h(i * 4096) & (buckets - 1)];
+
+  size_t max = 0;
+  for (size_t c : counts)
+    max = std::max(max, c);
+  // Mean is 64; a uniform hash stays well under 2x
+  assert(max < 128);
+
+  print_test_status("Integer Low Bits", max < 128);
+}
+
+void test_integer_avalanche() {
+  std::cout << "\n--- Running Integer Avalanche Test ---" << std::endl;
+  concurrent::hash<uint64_t> h;
+
+  // Flipping one input bit flips about half of the output bits
+  double total = 0;
+  int samples = 0;
+  for (uint64_t x = 1; x < 2000; x += 7) {
+    for (int bit = 0; bit < 64; ++bit) {
+      uint64_t diff = h(x) ^ h(x ^ (uint64_t(1) << bit));
+      total += std::bitset<64>(diff).count();
+      ++samples;
+    }
+  }
+  double mean = total / samples;
+  assert(mean > 28 && mean < 36);
+
+  print_test_status("Integer Avalanche", mean > 28 && mean < 36);
+}
+
+void test_string_consistency() {
+  std::cout << "\n--- Running String Consistency Test ---" << std::endl;
+  concurrent::hash<std::string> hs;
+  concurrent::hash<std::string_view> hv;
+  concurrent::hash<std::pmr::string> hp;
+
+  // Equal contents hash equally whatever the string type
+  std::vector<std::string> inputs;
+  for (size_t len = 0; len <= 130; ++len)
+    inputs.push_back(std::string(len, 'a') + std::to_string(len));
+  for (const auto &s : inputs) {
+    assert(hs(s) == hv(std::string_view(s)));
+    assert(hs(s) == hp(std::pmr::string(s)));
+  }
+
+  // Different strings of every length class get different hashes
+  std::set<size_t> seen;
+  for (const auto &s : inputs)
+    seen.insert(hs(s));
+  assert(seen.size() == inputs.size());
+
+  // Single-character differences anywhere in the key matter
+  std::string base(100, 'x');
+  std::set<size_t> variants;
+  for (size_t i = 0; i < base.size(); ++i) {
+    std::string v = base;
+    v[i] = 'y';
+    variants.insert(hs(v));
+  }
+  assert(variants.size() == base.size());
+
+  print_test_status("String Consistency", seen.size() == inputs.size());
+}
+
+void test_fallback() {
+  std::cout << "\n--- Running Fallback Test ---" << std::endl;
+  // Types without a specialization use std::hash
+  concurrent::hash<double> hd;
+  assert(hd(1.5) == std::hash<double>()(1.5));
+
+  print_test_status("Fallback", true);
+}
+
+void test_seeded_hash() {
+  std::cout << "\n--- Running Seeded Hash Test ---" << std::endl;
+  concurrent::seeded_hash<uint64_t> a, b;
+  // Independently constructed hashers get different seeds
+  assert(a.seed() != b.seed());
+
+  size_t differ = 0;
+  for (uint64_t i = 0; i < 64; ++i)
+    differ += a(i) != b(i);
+  assert(differ == 64);
+
+  // Copies keep the seed, a given seed always yields the same function
+  concurrent::seeded_hash<uint64_t> copy = a;
+  concurrent::seeded_hash<uint64_t> fixed(a.seed());
+  for (uint64_t i = 0; i < 64; ++i) {
+    assert(copy(i) == a(i));
+    assert(fixed(i) == a(i));
+  }
+
+  concurrent::seeded_hash<std::string> s1(1), s2(2);
+  assert(s1("key") == concurrent::seeded_hash<std::string>(1)("key"));
+  assert(s1("key") != s2("key"));
+
+  print_test_status("Seeded Hash", differ == 64);
+}
+
+int main() {
+  test_integer_low_bits();
+  test_integer_avalanche();
+  test_string_consistency();
+  test_fallback();
+  test_seeded_hash();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
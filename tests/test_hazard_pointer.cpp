@@ -0,0 +1,197 @@
+#include "../internal/hazard_pointer.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+std::atomic<int> live_nodes(0);
+
+struct tracked_node {
+  static constexpr int alive_marker = 0x5a5a5a5a;
+  int value;
+  int marker = alive_marker;
+
+  explicit tracked_node(int v) : value(v) { live_nodes.fetch_add(1); }
+  ~tracked_node() {
+    marker = 0;
+    live_nodes.fetch_sub(1);
+  }
+};
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_retire_and_reclaim() {
+  std::cout << "\n--- Running Single-threaded Retire Test ---" << std::endl;
+  {
+    concurrent::internal::hazard_domain domain(1000);
+
+    for (int i = 0; i < 10; ++i)
+      domain.retire(new tracked_node(i));
+    assert(domain.retired_count() == 10);
+    assert(domain.local_retired_count() == 10);
+    assert(live_nodes.load() == 10);
+
+    domain.reclaim();
+    assert(domain.retired_count() == 0);
+    assert(domain.reclaimed_count() == 10);
+    assert(live_nodes.load() == 0);
+
+    // Whatever is left retired is freed by the destructor
+    domain.retire(new tracked_node(42));
+    assert(live_nodes.load() == 1);
+  }
+  assert(live_nodes.load() == 0);
+
+  print_test_status("Single-threaded Retire", live_nodes.load() == 0);
+}
+
+void test_single_threaded_protected_node_survives() {
+  std::cout << "\n--- Running Single-threaded Protect Test ---" << std::endl;
+  concurrent::internal::hazard_domain domain(1000);
+  std::atomic<tracked_node *> shared(new tracked_node(1));
+
+  {
+    auto hp = domain.make_hazard_pointer();
+    tracked_node *node = hp.protect(shared);
+    assert(node->value == 1);
+
+    shared.store(new tracked_node(2));
+    domain.retire(node);
+    domain.reclaim();
+    // Still protected
+    assert(domain.retired_count() == 1);
+    assert(node->marker == tracked_node::alive_marker);
+  }
+  domain.reclaim();
+  assert(domain.retired_count() == 0);
+  assert(live_nodes.load() == 1);
+  delete shared.load();
+
+  print_test_status("Single-threaded Protect", live_nodes.load() == 0);
+}
+
+void test_single_threaded_slot_exhaustion() {
+  std::cout << "\n--- Running Single-threaded Slot Exhaustion Test ---"
+            << std::endl;
+  concurrent::internal::hazard_domain domain;
+  bool threw = false;
+  {
+    std::vector<concurrent::internal::hazard_domain::hazard_pointer> hps;
+    for (std::size_t i = 0; i < concurrent::internal::hazard_slots_per_thread;
+         ++i)
+      hps.push_back(domain.make_hazard_pointer());
+    try {
+      auto extra = domain.make_hazard_pointer();
+    } catch (const std::length_error &) {
+      threw = true;
+    }
+  }
+  assert(threw);
+  // Slots are released with their owners
+  auto again = domain.make_hazard_pointer();
+
+  print_test_status("Single-threaded Slot Exhaustion", threw);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_bounded_garbage() {
+  std::cout << "\n--- Running Multi-threaded Bounded Garbage Test ---"
+            << std::endl;
+  const std::size_t threshold = 32;
+  concurrent::internal::hazard_domain domain(threshold);
+  std::atomic<tracked_node *> shared(new tracked_node(0));
+  std::atomic<bool> protected_flag(false);
+  std::atomic<bool> release(false);
+
+  // A stalled reader holding one hazard pointer
+  std::thread reader([&]() {
+    auto hp = domain.make_hazard_pointer();
+    hp.protect(shared);
+    protected_flag.store(true);
+    while (!release.load())
+      std::this_thread::yield();
+  });
+  while (!protected_flag.load())
+    std::this_thread::yield();
+
+  std::size_t max_retired = 0;
+  for (int i = 0; i < 10000; ++i) {
+    domain.retire(shared.exchange(new tracked_node(i)));
+    max_retired = std::max(max_retired, domain.retired_count());
+  }
+  // The stalled reader pins exactly one node; everything else got freed
+  bool bounded = max_retired <= threshold;
+  assert(bounded);
+
+  release.store(true);
+  reader.join();
+  domain.reclaim();
+  assert(domain.retired_count() == 0);
+  delete shared.load();
+
+  print_test_status("Multi-threaded Bounded Garbage", bounded);
+}
+
+void test_multi_threaded_swap_and_read() {
+  std::cout << "\n--- Running Multi-threaded Swap And Read Test ---"
+            << std::endl;
+  std::atomic<bool> corrupted(false);
+  {
+    concurrent::internal::hazard_domain domain;
+    std::atomic<tracked_node *> shared(new tracked_node(0));
+    const int num_writers = 2;
+    const int num_readers = 4;
+    const int ops_per_thread = 20000;
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < num_writers; ++w) {
+      threads.emplace_back([&, w]() {
+        for (int i = 0; i < ops_per_thread; ++i)
+          domain.retire(shared.exchange(new tracked_node(w)));
+      });
+    }
+    for (int r = 0; r < num_readers; ++r) {
+      threads.emplace_back([&]() {
+        auto hp = domain.make_hazard_pointer();
+        for (int i = 0; i < ops_per_thread; ++i) {
+          tracked_node *node = hp.protect(shared);
+          if (node->marker != tracked_node::alive_marker)
+            corrupted.store(true);
+        }
+      });
+    }
+    for (auto &t : threads)
+      t.join();
+
+    assert(!corrupted.load());
+    delete shared.load();
+  }
+  assert(live_nodes.load() == 0);
+
+  print_test_status("Multi-threaded Swap And Read",
+                    !corrupted.load() && live_nodes.load() == 0);
+}
+
+int main() {
+  test_single_threaded_retire_and_reclaim();
+  test_single_threaded_protected_node_survives();
+  test_single_threaded_slot_exhaustion();
+
+  // Multi-threaded tests
+  test_multi_threaded_bounded_garbage();
+  test_multi_threaded_swap_and_read();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#ifndef CONCURRENT_STL_LOCK_STATS
+#define CONCURRENT_STL_LOCK_STATS
+#endif
+#include "../concurrent_unordered_map.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_counts() {
+  std::cout << "\n--- Running Single-threaded Lock Counts Test ---"
+            << std::endl;
+  static_assert(concurrent::lock_stats::enabled);
+  concurrent::unordered_map<int, int> map;
+
+  for (int i = 0; i < 10; ++i)
+    map.insert(i, i);
+  for (int i = 0; i < 5; ++i)
+    map.find(i);
+
+  concurrent::lock_stats stats = map.stats();
+  assert(stats.exclusive.acquisitions == 10);
+  assert(stats.shared.acquisitions == 5);
+  assert(stats.exclusive.contended == 0);
+  assert(stats.shared.contended == 0);
+  assert(stats.exclusive.hold.count == 10);
+  assert(stats.shared.wait.count == 5);
+
+  print_test_status("Single-threaded Lock Counts",
+                    stats.exclusive.acquisitions == 10);
+}
+
+void test_single_threaded_histogram() {
+  std::cout << "\n--- Running Single-threaded Histogram Test ---" << std::endl;
+  concurrent::latency_histogram h;
+  h.buckets[concurrent::internal::histogram_bucket(100)] = 90;
+  h.buckets[concurrent::internal::histogram_bucket(100000)] = 10;
+  h.count = 100;
+  h.total_ns = 90 * 100 + 10 * 100000;
+  h.max_ns = 100000;
+
+  // 100 lands in [64, 128), 100000 in [65536, 131072)
+  assert(h.percentile_ns(0.5) == 127);
+  assert(h.percentile_ns(0.99) == 100000);
+  assert(h.mean_ns() == 10090.0);
+
+  print_test_status("Single-threaded Histogram", true);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_contention() {
+  std::cout << "\n--- Running Multi-threaded Contention Test ---" << std::endl;
+  concurrent::unordered_map<int, int> map;
+  std::atomic<bool> holding(false);
+  std::atomic<int> started(0);
+
+  // Hold the exclusive lock until the readers have queued up behind it
+  std::thread writer([&]() {
+    map.execute_exclusive([&](auto &) {
+      holding.store(true);
+      while (started.load() < 4)
+        std::this_thread::yield();
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    });
+  });
+  while (!holding.load())
+    std::this_thread::yield();
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+    readers.emplace_back([&]() {
+      started.fetch_add(1);
+      map.find(1);
+    });
+  writer.join();
+  for (auto &t : readers)
+    t.join();
+
+  concurrent::lock_stats stats = map.stats();
+  assert(stats.exclusive.acquisitions == 1);
+  assert(stats.exclusive.hold.max_ns >= 40 * 1000 * 1000);
+  assert(stats.shared.acquisitions == 4);
+  assert(stats.shared.contended >= 1);
+  assert(stats.shared.wait.max_ns > 0);
+
+  print_test_status("Multi-threaded Contention", stats.shared.contended >= 1);
+}
+
+int main() {
+  test_single_threaded_counts();
+  test_single_threaded_histogram();
+
+  // Multi-threaded tests
+  test_multi_threaded_contention();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
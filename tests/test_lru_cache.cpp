@@ -0,0 +1,199 @@
+#include "../concurrent_lru_cache.h"
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::lru_cache<int, std::string> cache(3, 1);
+  assert(cache.empty() && cache.capacity() == 3 && cache.shard_count() == 1);
+  assert(!cache.get(1).has_value());
+
+  assert(cache.put(1, "one"));
+  assert(cache.put(2, "two"));
+  assert(cache.put(3, "three"));
+  assert(!cache.put(3, "THREE"));
+  assert(cache.get(3) == "THREE");
+
+  // 1 was used last, so 2 goes first
+  assert(cache.get(1) == "one");
+  cache.put(4, "four");
+  assert(!cache.contains(2) && cache.contains(1) && cache.size() == 3);
+
+  // contains() is not a use: 3 is now the oldest
+  assert(cache.contains(3));
+  cache.put(5, "five");
+  assert(!cache.contains(3));
+
+  assert(cache.erase(5) == 1 && cache.erase(5) == 0);
+  assert(cache.size() == 2);
+  cache.clear();
+  assert(cache.empty() && !cache.get(1).has_value());
+
+  // std::string keys, and a hash that keeps std::unordered_map as the table
+  concurrent::lru_cache<std::string, int> strings(2, 1);
+  concurrent::lru_cache<std::string, int, std::hash<std::string>> chained(2, 1);
+  strings.put("a", 1);
+  strings.put("b", 2);
+  strings.get("a");
+  strings.put("c", 3);
+  chained.put("a", 1);
+  chained.put("b", 2);
+  chained.get("a");
+  chained.put("c", 3);
+  bool passed = strings.contains("a") && !strings.contains("b") &&
+                chained.contains("a") && !chained.contains("b");
+  assert(passed);
+
+  print_test_status("Single-threaded Basic Ops", passed);
+}
+
+// Plain LRU to compare against
+class reference_lru {
+  size_t _capacity;
+  std::list<int> _order;
+  std::unordered_map<int, std::pair<int, std::list<int>::iterator>> _entries;
+
+public:
+  explicit reference_lru(size_t capacity) : _capacity(capacity) {}
+
+  std::optional<int> get(int key) {
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+      return std::nullopt;
+    _order.splice(_order.begin(), _order, it->second.second);
+    return it->second.first;
+  }
+
+  void put(int key, int value) {
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+      it->second.first = value;
+      _order.splice(_order.begin(), _order, it->second.second);
+      return;
+    }
+    _order.push_front(key);
+    _entries[key] = {value, _order.begin()};
+    if (_entries.size() > _capacity) {
+      _entries.erase(_order.back());
+      _order.pop_back();
+    }
+  }
+};
+
+void test_single_threaded_against_reference() {
+  std::cout << "\n--- Running Randomized Against Reference LRU Test ---"
+            << std::endl;
+  // With one shard and one thread every read is replayed, so the order is
+  // exact, including across read buffer overflows
+  concurrent::lru_cache<int, int> cache(100, 1);
+  reference_lru ref(100);
+  std::mt19937 rng(5);
+
+  bool same = true;
+  for (int i = 0; i < 200000 && same; ++i) {
+    int key = static_cast<int>(rng() % 300);
+    if (rng() % 4 == 0) {
+      cache.put(key, i);
+      ref.put(key, i);
+    } else {
+      same = cache.get(key) == ref.get(key);
+    }
+  }
+  assert(same);
+
+  // With several shards each one is bounded by its share
+  concurrent::lru_cache<int, int> sharded(1000, 8);
+  for (int i = 0; i < 100000; ++i)
+    sharded.put(static_cast<int>(rng() % 100000), i);
+  bool bounded = sharded.size() <= 1000 && sharded.size() > 900;
+
+  // Capacities that do not divide evenly, or smaller than the shard count,
+  // still bound the whole cache
+  concurrent::lru_cache<int, int> uneven(17, 16);
+  concurrent::lru_cache<int, int> tiny(3, 16);
+  for (int i = 0; i < 10000; ++i) {
+    uneven.put(i, i);
+    tiny.put(i, i);
+  }
+  bounded = bounded && uneven.size() <= 17 && tiny.size() <= 3;
+  assert(bounded);
+
+  print_test_status("Randomized Against Reference LRU", same && bounded);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_hits_and_puts() {
+  std::cout << "\n--- Running Multi-threaded Hits and Puts Test ---"
+            << std::endl;
+  const size_t capacity = 2000;
+  concurrent::lru_cache<long, long> cache(capacity);
+  const int num_threads = 4;
+  std::atomic<bool> consistent(true);
+  std::atomic<long> hits(0);
+
+  // Values are always key * 3, whoever put them; readers must never see
+  // anything else, and a skewed key distribution must mostly hit
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      long local_hits = 0;
+      for (int i = 0; i < 100000; ++i) {
+        long key = static_cast<long>(rng() % 1000);
+        if (rng() % 8 == 0)
+          key += static_cast<long>(rng() % 100000); // Cold keys
+        if (auto value = cache.get(key)) {
+          ++local_hits;
+          if (*value != key * 3)
+            consistent.store(false);
+        } else {
+          cache.put(key, key * 3);
+        }
+        if (i % 1000 == 0)
+          cache.erase(static_cast<long>(rng() % 1000));
+      }
+      hits += local_hits;
+    });
+  for (auto &t : threads)
+    t.join();
+
+  size_t per_shard = (capacity + cache.shard_count() - 1) / cache.shard_count();
+  bool bounded = cache.size() <= per_shard * cache.shard_count();
+  bool warm = hits.load() > num_threads * 100000 / 2;
+  assert(consistent.load());
+  assert(bounded);
+  assert(warm);
+
+  print_test_status("Multi-threaded Hits and Puts",
+                    consistent.load() && bounded && warm);
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_against_reference();
+
+  // Multi-threaded tests
+  test_multi_threaded_hits_and_puts();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,235 @@
+#include "../concurrent_map.h"
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::map<std::string, int> map;
+  assert(map.empty());
+  assert(!map.find("a").has_value());
+  assert(!map.lower_bound("").has_value());
+
+  assert(map.insert("b", 2));
+  assert(map.insert(std::string("d"), 4));
+  assert(!map.insert("b", 20));
+  assert(map.find("b") == 2);
+  assert(!map.insert_or_assign("b", 20));
+  assert(map.find("b") == 20);
+  assert(map.insert_or_assign("a", 1));
+  assert(map.size() == 3);
+  assert(map.contains("a") && !map.contains("c"));
+
+  auto lb = map.lower_bound("c");
+  assert(lb && lb->first == "d" && lb->second == 4);
+  assert(map.lower_bound("a")->first == "a");
+  assert(!map.lower_bound("e").has_value());
+
+  assert(map.erase("b") == 1);
+  assert(map.erase("b") == 0);
+  assert(!map.contains("b"));
+  assert(map.size() == 2);
+
+  map.clear();
+  assert(map.empty() && map.snapshot().empty());
+
+  // Other orderings
+  concurrent::map<int, int, std::greater<int>> reversed;
+  for (int i = 0; i < 10; ++i)
+    reversed.insert(i, i);
+  assert(reversed.snapshot().front().first == 9);
+
+  print_test_status("Single-threaded Basic Ops", map.empty());
+}
+
+void test_single_threaded_against_std_map() {
+  std::cout << "\n--- Running Randomized Against std::map Test ---"
+            << std::endl;
+  concurrent::map<int, std::string> map;
+  std::map<int, std::string> ref;
+  std::mt19937 rng(11);
+
+  for (int i = 0; i < 50000; ++i) {
+    int key = static_cast<int>(rng() % 2000);
+    switch (rng() % 4) {
+    case 0:
+      assert(map.insert(key, std::to_string(i)) ==
+             ref.emplace(key, std::to_string(i)).second);
+      break;
+    case 1:
+      assert(map.insert_or_assign(key, std::to_string(i)) ==
+             ref.insert_or_assign(key, std::to_string(i)).second);
+      break;
+    case 2:
+      assert(map.erase(key) == ref.erase(key));
+      break;
+    default: {
+      auto it = ref.lower_bound(key);
+      auto lb = map.lower_bound(key);
+      assert(lb.has_value() == (it != ref.end()));
+      if (lb)
+        assert(lb->first == it->first && lb->second == it->second);
+    }
+    }
+    assert(map.size() == ref.size());
+  }
+
+  auto all = map.snapshot();
+  bool same = std::equal(all.begin(), all.end(), ref.begin(), ref.end(),
+                         [](const auto &a, const auto &b) {
+                           return a.first == b.first && a.second == b.second;
+                         });
+  assert(same);
+
+  auto part = map.range(500, 700);
+  auto first = ref.lower_bound(500), last = ref.lower_bound(700);
+  assert(part.size() == static_cast<size_t>(std::distance(first, last)));
+  for (const auto &pair : part)
+    assert(pair.first >= 500 && pair.first < 700 && ref.at(pair.first) == pair.second);
+
+  print_test_status("Randomized Against std::map", same);
+}
+
+void test_single_threaded_reclamation() {
+  std::cout << "\n--- Running Single-threaded Reclamation Test ---"
+            << std::endl;
+  auto tracker = std::make_shared<int>(0);
+  {
+    concurrent::internal::epoch_domain domain(1);
+    {
+      concurrent::map<int, std::shared_ptr<int>> map(std::less<int>(), domain);
+      for (int i = 0; i < 100; ++i)
+        map.insert(i, tracker);
+      for (int i = 0; i < 50; ++i)
+        map.erase(i);
+      map.insert_or_assign(60, std::make_shared<int>(1));
+      assert(tracker.use_count() <= 101);
+    }
+    // The map destroys its remaining nodes
+    assert(tracker.use_count() <= 51);
+  }
+  // The domain frees the erased ones
+  assert(tracker.use_count() == 1);
+
+  print_test_status("Single-threaded Reclamation", tracker.use_count() == 1);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_writers_and_scans() {
+  std::cout << "\n--- Running Multi-threaded Writers and Scans Test ---"
+            << std::endl;
+  concurrent::map<long, long> map;
+  const int num_writers = 4;
+  const long per_writer = 5000;
+  std::atomic<bool> done(false);
+  std::atomic<bool> ordered(true);
+
+  // Scanners check that every scan comes back in strictly increasing order
+  // and that keys written once as "permanent" never disappear
+  std::vector<std::thread> threads;
+  for (int s = 0; s < 2; ++s)
+    threads.emplace_back([&] {
+      while (!done.load()) {
+        long prev = -1;
+        map.for_each_range(0, num_writers * per_writer, [&](long key, long value) {
+          if (key <= prev || value != key * 2)
+            ordered.store(false);
+          prev = key;
+        });
+      }
+    });
+
+  for (int w = 0; w < num_writers; ++w)
+    threads.emplace_back([&map, w] {
+      std::mt19937 rng(w);
+      for (long i = 0; i < per_writer; ++i) {
+        long key = w + i * num_writers;
+        map.insert(key, key * 2);
+        // Churn on keys of all writers, interleaved with the inserts
+        long other = static_cast<long>(rng() % (num_writers * per_writer));
+        if (other % 3 == 1) {
+          map.erase(other);
+          map.insert_or_assign(other, other * 2);
+        }
+      }
+    });
+
+  for (size_t t = 2; t < threads.size(); ++t)
+    threads[t].join();
+  done.store(true);
+  threads[0].join();
+  threads[1].join();
+
+  bool complete = map.size() == static_cast<size_t>(num_writers * per_writer);
+  for (long key = 0; complete && key < num_writers * per_writer; ++key)
+    complete = map.find(key) == key * 2;
+  assert(ordered.load());
+  assert(complete);
+
+  print_test_status("Multi-threaded Writers and Scans",
+                    ordered.load() && complete);
+}
+
+void test_multi_threaded_same_keys() {
+  std::cout << "\n--- Running Multi-threaded Same Keys Test ---" << std::endl;
+  concurrent::map<int, int> map;
+  const int num_threads = 4;
+  const int keys = 64;
+  std::atomic<long> inserted(0), erased(0);
+
+  // Every thread fights over the same few keys; inserts and erases that
+  // succeed must balance the final size
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(100 + t);
+      for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(rng() % keys);
+        if (rng() % 2)
+          inserted += map.insert(key, key);
+        else
+          erased += static_cast<long>(map.erase(key));
+        auto value = map.find(key);
+        assert(!value || *value == key);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+
+  long expected = inserted.load() - erased.load();
+  bool balanced = static_cast<long>(map.size()) == expected &&
+                  static_cast<long>(map.snapshot().size()) == expected;
+  assert(balanced);
+
+  print_test_status("Multi-threaded Same Keys", balanced);
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_against_std_map();
+  test_single_threaded_reclamation();
+
+  // Multi-threaded tests
+  test_multi_threaded_writers_and_scans();
+  test_multi_threaded_same_keys();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
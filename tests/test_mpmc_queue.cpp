@@ -0,0 +1,277 @@
+#include "../concurrent_mpmc_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_fifo() {
+  std::cout << "\n--- Running Single-threaded FIFO Test ---" << std::endl;
+  concurrent::mpmc_queue<std::string> queue(5);
+  assert(queue.capacity() == 8);
+  assert(queue.empty_approx());
+  assert(!queue.try_pop().has_value());
+
+  for (int i = 0; i < 8; ++i)
+    assert(queue.try_push(std::to_string(i)));
+  // Full
+  assert(!queue.try_push("x"));
+  assert(queue.size_approx() == 8);
+
+  std::string out;
+  assert(queue.try_pop(out) && out == "0");
+  assert(queue.try_emplace(3, 'z'));
+  for (int i = 1; i < 8; ++i)
+    assert(queue.pop() == std::to_string(i));
+  assert(queue.try_pop().value() == "zzz");
+  assert(queue.empty_approx());
+
+  // Wrap around the ring many times
+  for (int i = 0; i < 100; ++i) {
+    queue.push(std::to_string(i));
+    assert(queue.pop() == std::to_string(i));
+  }
+
+  print_test_status("Single-threaded FIFO", queue.empty_approx());
+}
+
+void test_single_threaded_batch() {
+  std::cout << "\n--- Running Single-threaded Batch Test ---" << std::endl;
+  concurrent::mpmc_queue<int> queue(16);
+
+  std::vector<int> in(20);
+  for (int i = 0; i < 20; ++i)
+    in[i] = i;
+  // Only as many as fit are pushed
+  assert(queue.try_push_n(in.begin(), in.size()) == 16);
+
+  std::vector<int> out;
+  assert(queue.try_pop_n(std::back_inserter(out), 10) == 10);
+  assert(queue.try_push_n(in.begin() + 16, 4) == 4);
+  assert(queue.try_pop_n(std::back_inserter(out), 100) == 10);
+  assert(out == in);
+  assert(queue.try_pop_n(std::back_inserter(out), 1) == 0);
+
+  print_test_status("Single-threaded Batch", out == in);
+}
+
+void test_single_threaded_destruction() {
+  std::cout << "\n--- Running Single-threaded Destruction Test ---"
+            << std::endl;
+  auto tracker = std::make_shared<int>(0);
+  {
+    concurrent::mpmc_queue<std::shared_ptr<int>> queue(8);
+    for (int i = 0; i < 5; ++i)
+      queue.push(tracker);
+    queue.pop();
+    assert(tracker.use_count() == 5);
+  }
+  // Elements left in the queue are destroyed with it
+  assert(tracker.use_count() == 1);
+
+  print_test_status("Single-threaded Destruction", tracker.use_count() == 1);
+}
+
+// Copy constructor throws on demand; moves never do
+struct fragile {
+  static inline bool fail_copies = false;
+  static inline int live = 0;
+  int value;
+
+  explicit fragile(int v) : value(v) { ++live; }
+  fragile(const fragile &other) : value(other.value) {
+    if (fail_copies && value % 3 == 2)
+      throw std::runtime_error("copy failed");
+    ++live;
+  }
+  fragile(fragile &&other) noexcept : value(other.value) { ++live; }
+  fragile &operator=(const fragile &) = default;
+  fragile &operator=(fragile &&) noexcept = default;
+  ~fragile() { --live; }
+};
+
+// Output iterator that hands each element to f
+template <typename F> struct function_output {
+  F *f;
+  function_output &operator*() { return *this; }
+  function_output &operator++(int) { return *this; }
+  function_output &operator=(fragile &&value) {
+    (*f)(value);
+    return *this;
+  }
+};
+
+template <typename F> function_output<F> make_function_output(F &f) {
+  return {&f};
+}
+
+void test_single_threaded_throwing_copy() {
+  std::cout << "\n--- Running Single-threaded Throwing Copy Test ---"
+            << std::endl;
+  std::vector<fragile> in;
+  for (int i = 0; i < 6; ++i)
+    in.emplace_back(i);
+  {
+    concurrent::mpmc_queue<fragile> queue(8);
+    fragile::fail_copies = true;
+    // A failed copy claims no cell, so the queue keeps flowing
+    int thrown = 0;
+    for (const fragile &f : in) {
+      try {
+        queue.push(f);
+      } catch (const std::runtime_error &) {
+        ++thrown;
+      }
+    }
+    assert(thrown == 2);
+    try {
+      queue.try_push_n(in.begin(), in.size());
+    } catch (const std::runtime_error &) {
+      ++thrown;
+    }
+    assert(thrown == 3);
+    fragile::fail_copies = false;
+    assert(queue.try_push_n(in.begin(), 2) == 2);
+
+    std::vector<int> out;
+    while (auto f = queue.try_pop())
+      out.push_back(f->value);
+    assert((out == std::vector<int>{0, 1, 3, 4, 0, 1}));
+    queue.push(in[5]);
+    assert(queue.pop().value == 5);
+  }
+  // Writing a popped element fails: every claimed cell is still released,
+  // so producers can wrap around onto them
+  {
+    concurrent::mpmc_queue<fragile> queue(4);
+    for (int i = 0; i < 4; ++i)
+      queue.emplace(i);
+    std::vector<int> seen;
+    auto sink = [&seen](const fragile &f) {
+      if (f.value == 1)
+        throw std::runtime_error("write failed");
+      seen.push_back(f.value);
+    };
+    bool pop_thrown = false;
+    try {
+      queue.try_pop_n(make_function_output(sink), 4);
+    } catch (const std::runtime_error &) {
+      pop_thrown = true;
+    }
+    assert(pop_thrown && seen == std::vector<int>{0});
+    assert(queue.empty_approx());
+    for (int i = 0; i < 4; ++i)
+      assert(queue.try_emplace(i + 10));
+    assert(queue.pop().value == 10);
+  }
+  // Nothing built for a failed push or pop was leaked
+  bool balanced = fragile::live == static_cast<int>(in.size());
+  assert(balanced);
+
+  print_test_status("Single-threaded Throwing Copy", balanced);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_producers_consumers() {
+  std::cout << "\n--- Running Multi-threaded Producers/Consumers Test ---"
+            << std::endl;
+  concurrent::mpmc_queue<long> queue(64);
+  const int num_producers = 4;
+  const int num_consumers = 4;
+  const long per_producer = 20000;
+
+  std::vector<std::vector<long>> received(num_consumers);
+  std::atomic<long> remaining(num_producers * per_producer);
+  std::vector<std::thread> threads;
+
+  for (int p = 0; p < num_producers; ++p) {
+    threads.emplace_back([&queue, p] {
+      std::vector<long> batch;
+      for (long i = 0; i < per_producer; ++i) {
+        long value = p * per_producer + i;
+        // Half the producers push in batches
+        if (p % 2) {
+          queue.push(value);
+          continue;
+        }
+        batch.push_back(value);
+        if (batch.size() == 8) {
+          size_t done = 0;
+          while (done < batch.size())
+            done += queue.try_push_n(batch.begin() + done, batch.size() - done);
+          batch.clear();
+        }
+      }
+      for (long value : batch)
+        queue.push(value);
+    });
+  }
+  for (int c = 0; c < num_consumers; ++c) {
+    threads.emplace_back([&, c] {
+      std::vector<long> &mine = received[c];
+      while (remaining.load() > 0) {
+        size_t got = 0;
+        if (c % 2) {
+          got = queue.try_pop_n(std::back_inserter(mine), 16);
+        } else if (auto value = queue.try_pop()) {
+          mine.push_back(*value);
+          got = 1;
+        }
+        remaining.fetch_sub(static_cast<long>(got));
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  // Every value arrives exactly once, and each consumer sees the values of
+  // one producer in the order they were pushed
+  std::vector<long> all;
+  bool ordered = true;
+  for (const auto &mine : received) {
+    std::vector<long> last(num_producers, -1);
+    for (long value : mine) {
+      long producer = value / per_producer;
+      ordered = ordered && value > last[producer];
+      last[producer] = value;
+    }
+    all.insert(all.end(), mine.begin(), mine.end());
+  }
+  std::sort(all.begin(), all.end());
+  bool complete = all.size() == static_cast<size_t>(num_producers * per_producer);
+  for (size_t i = 0; complete && i < all.size(); ++i)
+    complete = all[i] == static_cast<long>(i);
+  assert(ordered);
+  assert(complete);
+  assert(queue.empty_approx());
+
+  print_test_status("Multi-threaded Producers/Consumers", ordered && complete);
+}
+
+int main() {
+  test_single_threaded_fifo();
+  test_single_threaded_batch();
+  test_single_threaded_destruction();
+  test_single_threaded_throwing_copy();
+
+  // Multi-threaded tests
+  test_multi_threaded_producers_consumers();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
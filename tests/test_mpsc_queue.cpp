@@ -0,0 +1,209 @@
+#include "../concurrent_mpsc_queue.h"
+#include "../concurrent_pool_allocator.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+struct message : concurrent::mpsc_hook {
+  int id;
+  explicit message(int i) : id(i) {}
+};
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_intrusive() {
+  std::cout << "\n--- Running Single-threaded Intrusive Test ---" << std::endl;
+  concurrent::intrusive_mpsc_queue<message> queue;
+  assert(queue.empty_approx());
+  assert(queue.pop() == nullptr);
+
+  std::vector<message> messages;
+  for (int i = 0; i < 10; ++i)
+    messages.emplace_back(i);
+
+  queue.push(&messages[0]);
+  assert(!queue.empty_approx());
+  assert(queue.pop() == &messages[0]);
+  assert(queue.pop() == nullptr);
+  assert(queue.empty_approx());
+
+  for (auto &m : messages)
+    queue.push(&m);
+  int next = 0;
+  assert(queue.drain([&](message *m) { assert(m->id == next++); }, 4) == 4);
+  assert(!queue.empty_approx());
+  assert(queue.drain([&](message *m) { assert(m->id == next++); }) == 6);
+  assert(next == 10);
+
+  // Popped nodes can be pushed again
+  queue.push(&messages[3]);
+  queue.push(&messages[1]);
+  assert(queue.pop()->id == 3);
+  assert(queue.pop()->id == 1);
+  assert(queue.empty_approx());
+
+  print_test_status("Single-threaded Intrusive", queue.empty_approx());
+}
+
+void test_single_threaded_values() {
+  std::cout << "\n--- Running Single-threaded Values Test ---" << std::endl;
+  concurrent::mpsc_queue<std::string> queue;
+  assert(!queue.try_pop().has_value());
+
+  queue.push("a");
+  queue.emplace(3, 'b');
+  std::string s = "c";
+  queue.push(s);
+  assert(queue.try_pop().value() == "a");
+  std::string out;
+  assert(queue.try_pop(out) && out == "bbb");
+
+  for (int i = 0; i < 5; ++i)
+    queue.push(std::to_string(i));
+  std::vector<std::string> drained;
+  assert(queue.drain([&](std::string &&v) {
+    drained.push_back(std::move(v));
+  }) == 6);
+  assert((drained == std::vector<std::string>{"c", "0", "1", "2", "3", "4"}));
+  assert(queue.empty_approx());
+
+  // A throwing handler loses only the element it was given
+  queue.push("x");
+  queue.push("y");
+  bool threw = false;
+  try {
+    queue.drain([](std::string &&) { throw 1; });
+  } catch (int) {
+    threw = true;
+  }
+  assert(threw);
+  assert(queue.try_pop().value() == "y");
+
+  auto tracker = std::make_shared<int>(0);
+  {
+    concurrent::mpsc_queue<std::shared_ptr<int>,
+                           concurrent::pool_allocator<std::shared_ptr<int>>>
+        owned;
+    for (int i = 0; i < 4; ++i)
+      owned.push(tracker);
+    owned.try_pop();
+    assert(tracker.use_count() == 4);
+  }
+  // Elements left in the queue are destroyed with it
+  assert(tracker.use_count() == 1);
+
+  print_test_status("Single-threaded Values", tracker.use_count() == 1);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_producers() {
+  std::cout << "\n--- Running Multi-threaded Producers Test ---" << std::endl;
+  concurrent::mpsc_queue<long> queue;
+  const int num_producers = 4;
+  const long per_producer = 20000;
+  const long total = num_producers * per_producer;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p)
+    producers.emplace_back([&queue, p] {
+      for (long i = 0; i < per_producer; ++i)
+        queue.push(p * per_producer + i);
+    });
+
+  // The consumer sees each producer's values in the order they were pushed
+  std::vector<long> last(num_producers);
+  for (int p = 0; p < num_producers; ++p)
+    last[p] = p * per_producer - 1;
+  long received = 0;
+  bool ordered = true;
+  while (received < total) {
+    size_t got = queue.drain(
+        [&](long value) {
+          long producer = value / per_producer;
+          ordered = ordered && value == last[producer] + 1;
+          last[producer] = value;
+        },
+        64);
+    if (!got)
+      std::this_thread::yield();
+    received += static_cast<long>(got);
+  }
+  for (auto &t : producers)
+    t.join();
+
+  assert(ordered);
+  assert(received == total);
+  assert(queue.empty_approx());
+
+  print_test_status("Multi-threaded Producers", ordered && received == total);
+}
+
+void test_multi_threaded_intrusive_mailbox() {
+  std::cout << "\n--- Running Multi-threaded Intrusive Mailbox Test ---"
+            << std::endl;
+  concurrent::intrusive_mpsc_queue<message> mailbox;
+  const int num_producers = 4;
+  const int per_producer = 10000;
+
+  // Each producer owns its nodes; the consumer hands them back through done
+  std::vector<std::vector<message>> nodes(num_producers);
+  std::vector<std::atomic<int>> done(num_producers);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; ++p) {
+    for (int i = 0; i < per_producer; ++i)
+      nodes[p].emplace_back(p * per_producer + i);
+    done[p].store(0);
+    producers.emplace_back([&, p] {
+      for (auto &m : nodes[p])
+        mailbox.push(&m);
+    });
+  }
+
+  long sum = 0;
+  int received = 0;
+  while (received < num_producers * per_producer) {
+    message *m = mailbox.pop();
+    if (!m) {
+      std::this_thread::yield();
+      continue;
+    }
+    sum += m->id;
+    done[m->id / per_producer].fetch_add(1);
+    ++received;
+  }
+  for (auto &t : producers)
+    t.join();
+
+  long n = num_producers * per_producer;
+  bool complete = sum == n * (n - 1) / 2;
+  for (auto &d : done)
+    complete = complete && d.load() == per_producer;
+  assert(complete);
+  assert(mailbox.pop() == nullptr);
+
+  print_test_status("Multi-threaded Intrusive Mailbox", complete);
+}
+
+int main() {
+  test_single_threaded_intrusive();
+  test_single_threaded_values();
+
+  // Multi-threaded tests
+  test_multi_threaded_producers();
+  test_multi_threaded_intrusive_mailbox();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
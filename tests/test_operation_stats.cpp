@@ -0,0 +1,119 @@
+#ifndef CONCURRENT_STL_OP_STATS
+#define CONCURRENT_STL_OP_STATS
+#endif
+#include "../concurrent_unordered_map.h"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_counts() {
+  std::cout << "\n--- Running Single-threaded Operation Counts Test ---"
+            << std::endl;
+  static_assert(concurrent::operation_stats::enabled);
+  concurrent::unordered_map<int, int> map;
+
+  for (int i = 0; i < 10; ++i)
+    map.insert(i, i);
+  map.emplace(10, 10);
+  for (int i = 0; i < 15; ++i)
+    map.find(i); // 11 hits, 4 misses
+  map.count(3);
+  map.erase(1);
+  map.erase(100);
+  map.snapshot();
+
+  concurrent::operation_stats stats = map.op_stats();
+  assert(stats.insert.count == 11);
+  assert(stats.find.count == 16);
+  assert(stats.find_hits == 12);
+  assert(stats.find_misses == 4);
+  assert(stats.hit_ratio() == 12.0 / 16.0);
+  assert(stats.erase.count == 2);
+  assert(stats.snapshot.count == 1);
+
+  print_test_status("Single-threaded Operation Counts",
+                    stats.insert.count == 11);
+}
+
+void test_single_threaded_rehash_events() {
+  std::cout << "\n--- Running Single-threaded Rehash Events Test ---"
+            << std::endl;
+  concurrent::unordered_map<int, int> map;
+
+  size_t bucket_changes = 0;
+  size_t buckets = 0;
+  for (int i = 0; i < 1000; ++i) {
+    map.insert(i, i);
+    size_t now = map.execute_shared(
+        [](const auto &internal_map) { return internal_map.bucket_count(); });
+    if (now != buckets)
+      ++bucket_changes;
+    buckets = now;
+  }
+  concurrent::operation_stats stats = map.op_stats();
+  assert(stats.rehashes() == bucket_changes);
+  assert(stats.rehashes() > 0);
+
+  // reserve() and rehash() only count when the table actually changes
+  map.reserve(100000);
+  assert(map.op_stats().rehashes() == bucket_changes + 1);
+  buckets = map.execute_shared(
+      [](const auto &internal_map) { return internal_map.bucket_count(); });
+  map.rehash(buckets);
+  assert(map.op_stats().rehashes() == bucket_changes + 1);
+  assert(map.op_stats().rehash.max_ns > 0);
+
+  print_test_status("Single-threaded Rehash Events", bucket_changes > 0);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_aggregation() {
+  std::cout << "\n--- Running Multi-threaded Aggregation Test ---" << std::endl;
+  concurrent::unordered_map<int, int> map;
+  const int num_threads = 8;
+  const int ops_per_thread = 2000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < ops_per_thread; ++i) {
+        map.insert(t * ops_per_thread + i, i);
+        map.find(t * ops_per_thread + i);
+      }
+    });
+  for (auto &th : threads)
+    th.join();
+
+  concurrent::operation_stats stats = map.op_stats();
+  const uint64_t total = uint64_t(num_threads) * ops_per_thread;
+  assert(stats.insert.count == total);
+  assert(stats.find.count == total);
+  assert(stats.find_hits == total);
+  assert(stats.find_misses == 0);
+
+  print_test_status("Multi-threaded Aggregation",
+                    stats.insert.count == total);
+}
+
+int main() {
+  test_single_threaded_counts();
+  test_single_threaded_rehash_events();
+
+  // Multi-threaded tests
+  test_multi_threaded_aggregation();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
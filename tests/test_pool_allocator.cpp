@@ -0,0 +1,140 @@
+#include "../concurrent_pool_allocator.h"
+#include "../concurrent_unordered_map.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+template <typename Key, typename Value>
+using pooled_map = concurrent::unordered_map<
+    Key, Value, std::hash<Key>, std::equal_to<Key>,
+    concurrent::pool_allocator<std::pair<const Key, Value>>>;
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_allocate() {
+  std::cout << "\n--- Running Single-threaded Allocate Test ---" << std::endl;
+  concurrent::pool_allocator<std::uint64_t> alloc;
+
+  // Small blocks come from the pool, are 16-byte aligned and reused
+  std::vector<std::uint64_t *> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    std::uint64_t *p = alloc.allocate(2);
+    assert(reinterpret_cast<std::uintptr_t>(p) % 16 == 0);
+    p[0] = i;
+    p[1] = i;
+    blocks.push_back(p);
+  }
+  for (int i = 0; i < 1000; ++i)
+    assert(blocks[i][0] == static_cast<std::uint64_t>(i));
+  std::uint64_t *last = blocks.back();
+  for (auto *p : blocks)
+    alloc.deallocate(p, 2);
+  std::uint64_t *reused = alloc.allocate(2);
+  assert(reused == last);
+  alloc.deallocate(reused, 2);
+
+  // Large requests bypass the pool
+  std::uint64_t *big = alloc.allocate(1000);
+  big[999] = 1;
+  alloc.deallocate(big, 1000);
+
+  // Rebinding keeps allocators interchangeable
+  concurrent::pool_allocator<char> rebound(alloc);
+  assert(rebound == alloc);
+
+  print_test_status("Single-threaded Allocate", true);
+}
+
+void test_single_threaded_map() {
+  std::cout << "\n--- Running Single-threaded Pooled Map Test ---"
+            << std::endl;
+  pooled_map<int, std::string> map;
+
+  for (int i = 0; i < 1000; ++i)
+    map.insert(i, std::to_string(i));
+  assert(map.size() == 1000);
+  assert(map.find(500).value() == "500");
+  for (int i = 0; i < 1000; i += 2)
+    map.erase(i);
+  assert(map.size() == 500);
+  assert(!map.find(500).has_value());
+  assert(map.find(501).value() == "501");
+
+  pooled_map<int, std::string> moved(std::move(map));
+  assert(moved.size() == 500);
+
+  print_test_status("Single-threaded Pooled Map", moved.size() == 500);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_cross_thread_free() {
+  std::cout << "\n--- Running Multi-threaded Cross-thread Free Test ---"
+            << std::endl;
+  const int num_threads = 4;
+  const int items_per_thread = 5000;
+  pooled_map<int, int> map;
+
+  // Producers insert, then consumers on other threads erase: blocks allocated
+  // by one thread are freed by another
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < items_per_thread; ++i)
+        map.insert(t * items_per_thread + i, i);
+    });
+  for (auto &th : threads)
+    th.join();
+  assert(map.size() == num_threads * items_per_thread);
+
+  threads.clear();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t]() {
+      int victim = (t + 1) % num_threads;
+      for (int i = 0; i < items_per_thread; ++i)
+        map.erase(victim * items_per_thread + i);
+    });
+  for (auto &th : threads)
+    th.join();
+  assert(map.empty());
+
+  // Threads that exited handed their caches back; a fresh round still works
+  threads.clear();
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < items_per_thread; ++i)
+        map.insert(t * items_per_thread + i, i);
+    });
+  for (auto &th : threads)
+    th.join();
+  bool all_found = true;
+  for (int k = 0; k < num_threads * items_per_thread; ++k)
+    if (map.find(k).value_or(-1) != k % items_per_thread)
+      all_found = false;
+  assert(all_found);
+
+  print_test_status("Multi-threaded Cross-thread Free", all_found);
+}
+
+int main() {
+  test_single_threaded_allocate();
+  test_single_threaded_map();
+
+  // Multi-threaded tests
+  test_multi_threaded_cross_thread_free();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
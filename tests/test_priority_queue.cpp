@@ -0,0 +1,172 @@
+#include "../concurrent_priority_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_strict_order() {
+  std::cout << "\n--- Running Single-threaded Strict Order Test ---"
+            << std::endl;
+  concurrent::priority_queue<int> queue;
+  assert(queue.order() == concurrent::priority_order::strict);
+  int value = 0;
+  assert(!queue.try_pop(value) && !queue.try_pop().has_value());
+  assert(queue.empty_approx());
+
+  std::mt19937 rng(3);
+  std::vector<int> pushed;
+  for (int i = 0; i < 1000; ++i) {
+    pushed.push_back(static_cast<int>(rng() % 500));
+    queue.push(pushed.back());
+  }
+  std::vector<int> batch = {1000, -1, 250};
+  queue.push(batch.begin(), batch.end());
+  pushed.insert(pushed.end(), batch.begin(), batch.end());
+  assert(queue.size_approx() == pushed.size());
+
+  // Greatest first, then the rest in batches
+  std::sort(pushed.begin(), pushed.end(), std::greater<int>());
+  std::vector<int> popped;
+  assert(queue.try_pop() == 1000);
+  popped.push_back(1000);
+  while (queue.pop_n(std::back_inserter(popped), 64) > 0) {
+  }
+  bool ordered = popped == pushed && queue.empty_approx();
+  assert(ordered);
+
+  // Earliest deadline first, with move-only elements
+  auto later = [](const std::unique_ptr<int> &a,
+                  const std::unique_ptr<int> &b) { return *a > *b; };
+  concurrent::priority_queue<std::unique_ptr<int>, decltype(later)> timers(
+      concurrent::priority_order::strict, 0, later);
+  for (int deadline : {30, 10, 20})
+    timers.push(std::make_unique<int>(deadline));
+  std::unique_ptr<int> next;
+  assert(timers.try_pop(next) && *next == 10);
+  assert(*timers.try_pop().value() == 20);
+
+  print_test_status("Single-threaded Strict Order", ordered);
+}
+
+void test_single_threaded_relaxed_order() {
+  std::cout << "\n--- Running Single-threaded Relaxed Order Test ---"
+            << std::endl;
+  const size_t heaps = 8;
+  concurrent::priority_queue<int> queue(concurrent::priority_order::relaxed,
+                                        heaps);
+  assert(queue.order() == concurrent::priority_order::relaxed);
+
+  std::multiset<int, std::greater<int>> remaining;
+  for (int i = 0; i < 20000; ++i) {
+    queue.push(i);
+    remaining.insert(i);
+  }
+
+  // Every element comes back once, and pops stay close to the top
+  size_t total_rank = 0;
+  int value;
+  while (queue.try_pop(value)) {
+    auto it = remaining.find(value);
+    assert(it != remaining.end());
+    total_rank += static_cast<size_t>(std::distance(remaining.begin(), it));
+    remaining.erase(it);
+  }
+  double mean_rank = static_cast<double>(total_rank) / 20000;
+  bool passed = remaining.empty() && mean_rank < 4.0 * heaps;
+  assert(passed);
+
+  print_test_status("Single-threaded Relaxed Order", passed);
+}
+
+// --- Multi-threaded Tests ---
+
+void run_producers_consumers(concurrent::priority_order order,
+                             const std::string &name) {
+  std::cout << "\n--- Running Multi-threaded " << name << " Test ---"
+            << std::endl;
+  concurrent::priority_queue<long> queue(order);
+  const int num_producers = 4;
+  const int num_consumers = 4;
+  const long per_producer = 50000;
+  std::atomic<int> producers_done(0);
+  std::vector<std::vector<long>> received(num_consumers);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < num_producers; ++p)
+    threads.emplace_back([&, p] {
+      std::vector<long> batch;
+      for (long i = 0; i < per_producer; ++i) {
+        long value = p * per_producer + i;
+        if (i % 4 == 0) {
+          queue.push(value);
+          continue;
+        }
+        batch.push_back(value);
+        if (batch.size() == 16) {
+          queue.push(batch.begin(), batch.end());
+          batch.clear();
+        }
+      }
+      queue.push(batch.begin(), batch.end());
+      producers_done.fetch_add(1);
+    });
+  for (int c = 0; c < num_consumers; ++c)
+    threads.emplace_back([&, c] {
+      for (;;) {
+        bool finished = producers_done.load() == num_producers;
+        long value;
+        if (c % 2 == 0 ? queue.try_pop(value)
+                       : queue.pop_n(&value, 1) == 1) {
+          received[c].push_back(value);
+        } else if (finished) {
+          break;
+        } else {
+          std::this_thread::yield();
+        }
+        queue.pop_n(std::back_inserter(received[c]), 8);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+
+  // Every element popped exactly once
+  std::vector<long> all;
+  for (auto &r : received)
+    all.insert(all.end(), r.begin(), r.end());
+  std::sort(all.begin(), all.end());
+  bool exact = all.size() == static_cast<size_t>(num_producers * per_producer);
+  for (size_t i = 0; exact && i < all.size(); ++i)
+    exact = all[i] == static_cast<long>(i);
+  assert(exact);
+
+  print_test_status("Multi-threaded " + name, exact);
+}
+
+int main() {
+  test_single_threaded_strict_order();
+  test_single_threaded_relaxed_order();
+
+  // Multi-threaded tests
+  run_producers_consumers(concurrent::priority_order::strict, "Strict");
+  run_producers_consumers(concurrent::priority_order::relaxed, "Relaxed");
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
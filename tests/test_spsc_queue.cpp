@@ -0,0 +1,229 @@
+#include "../concurrent_spsc_queue.h"
+
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_fifo() {
+  std::cout << "\n--- Running Single-threaded FIFO Test ---" << std::endl;
+  concurrent::spsc_queue<std::string> queue(3);
+  assert(queue.capacity() == 4);
+  assert(queue.empty_approx());
+  assert(!queue.try_pop().has_value());
+
+  for (int i = 0; i < 4; ++i)
+    assert(queue.try_push(std::to_string(i)));
+  // Full
+  assert(!queue.try_push("x"));
+  assert(queue.size_approx() == 4);
+
+  std::string out;
+  assert(queue.try_pop(out) && out == "0");
+  assert(queue.try_emplace(2, 'z'));
+  for (int i = 1; i < 4; ++i)
+    assert(queue.pop() == std::to_string(i));
+  assert(queue.try_pop().value() == "zz");
+  assert(queue.empty_approx());
+
+  // Wrap around the ring many times
+  for (int i = 0; i < 100; ++i) {
+    queue.push(std::to_string(i));
+    assert(queue.pop() == std::to_string(i));
+  }
+
+  print_test_status("Single-threaded FIFO", queue.empty_approx());
+}
+
+void test_single_threaded_batch() {
+  std::cout << "\n--- Running Single-threaded Batch Test ---" << std::endl;
+  concurrent::spsc_queue<int> queue(16);
+
+  std::vector<int> in(20);
+  for (int i = 0; i < 20; ++i)
+    in[i] = i;
+  // Only as many as fit are pushed
+  assert(queue.push_n(in.begin(), in.size()) == 16);
+  assert(queue.push_n(in.begin(), 1) == 0);
+
+  std::vector<int> out;
+  assert(queue.pop_n(std::back_inserter(out), 10) == 10);
+  assert(queue.push_n(in.begin() + 16, 4) == 4);
+  assert(queue.pop_n(std::back_inserter(out), 100) == 10);
+  assert(out == in);
+  assert(queue.pop_n(std::back_inserter(out), 1) == 0);
+
+  print_test_status("Single-threaded Batch", out == in);
+}
+
+void test_single_threaded_destruction() {
+  std::cout << "\n--- Running Single-threaded Destruction Test ---"
+            << std::endl;
+  auto tracker = std::make_shared<int>(0);
+  {
+    concurrent::spsc_queue<std::shared_ptr<int>> queue(8);
+    for (int i = 0; i < 5; ++i)
+      queue.push(tracker);
+    queue.pop();
+    assert(tracker.use_count() == 5);
+  }
+  // Elements left in the queue are destroyed with it
+  assert(tracker.use_count() == 1);
+
+  print_test_status("Single-threaded Destruction", tracker.use_count() == 1);
+}
+
+// Copy constructor throws for some values; counts live instances
+struct fragile {
+  static inline int live = 0;
+  int value;
+
+  explicit fragile(int v) : value(v) { ++live; }
+  fragile(const fragile &other) : value(other.value) {
+    if (value < 0)
+      throw std::runtime_error("copy failed");
+    ++live;
+  }
+  fragile(fragile &&other) noexcept : value(other.value) { ++live; }
+  fragile &operator=(const fragile &) = default;
+  ~fragile() { --live; }
+};
+
+// Output iterator that hands each element to f
+template <typename F> struct function_output {
+  F *f;
+  function_output &operator*() { return *this; }
+  function_output &operator++(int) { return *this; }
+  function_output &operator=(fragile &&value) {
+    (*f)(value);
+    return *this;
+  }
+};
+
+template <typename F> function_output<F> make_function_output(F &f) {
+  return {&f};
+}
+
+void test_single_threaded_throwing_batch() {
+  std::cout << "\n--- Running Single-threaded Throwing Batch Test ---"
+            << std::endl;
+  std::vector<fragile> in;
+  for (int v : {1, 2, -3, 4})
+    in.emplace_back(v);
+  bool thrown = false;
+  {
+    concurrent::spsc_queue<fragile> queue(8);
+    queue.push(in[0]);
+    try {
+      queue.push_n(in.begin(), in.size());
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    // The copies made before the failure are gone, and the queue is as it
+    // was
+    assert(thrown);
+    assert(fragile::live == static_cast<int>(in.size()) + 1);
+    assert(queue.size_approx() == 1);
+    assert(queue.push_n(in.begin(), 2) == 2);
+    assert(queue.pop().value == 1 && queue.pop().value == 1);
+    assert(queue.pop().value == 2);
+  }
+  bool balanced = fragile::live == static_cast<int>(in.size());
+  assert(balanced);
+
+  // Writing a popped element fails: the ones taken so far are gone from the
+  // queue, the rest stay in it
+  bool pop_thrown = false;
+  {
+    concurrent::spsc_queue<fragile> queue(8);
+    for (int v : {1, 2, -3, 4})
+      queue.emplace(v);
+    std::vector<int> seen;
+    auto sink = [&seen](const fragile &f) {
+      if (f.value < 0)
+        throw std::runtime_error("write failed");
+      seen.push_back(f.value);
+    };
+    try {
+      queue.pop_n(make_function_output(sink), 4);
+    } catch (const std::runtime_error &) {
+      pop_thrown = true;
+    }
+    assert(pop_thrown);
+    assert(seen.size() == 2 && queue.size_approx() == 1);
+    assert(queue.pop().value == 4);
+    queue.emplace(-5);
+    fragile target(0);
+    assert(queue.try_pop(target) && target.value == -5);
+  }
+  balanced = balanced && fragile::live == static_cast<int>(in.size());
+  assert(balanced);
+
+  print_test_status("Single-threaded Throwing Batch",
+                    thrown && pop_thrown && balanced);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_pipeline() {
+  std::cout << "\n--- Running Multi-threaded Pipeline Test ---" << std::endl;
+  // Two stages: single elements into the first queue, batches out of it and
+  // into the second
+  concurrent::spsc_queue<long> first(64);
+  concurrent::spsc_queue<long> second(32);
+  const long count = 200000;
+
+  std::thread producer([&] {
+    for (long i = 0; i < count; ++i)
+      first.push(i);
+  });
+  std::thread stage([&] {
+    long batch[24];
+    for (long moved = 0; moved < count;) {
+      size_t got = first.pop_n(batch, 24);
+      for (size_t done = 0; done < got;)
+        done += second.push_n(batch + done, got - done);
+      moved += static_cast<long>(got);
+    }
+  });
+
+  bool ordered = true;
+  for (long i = 0; i < count; ++i) {
+    long value;
+    while (!second.try_pop(value))
+      std::this_thread::yield();
+    ordered = ordered && value == i;
+  }
+  producer.join();
+  stage.join();
+
+  assert(ordered);
+  assert(first.empty_approx() && second.empty_approx());
+
+  print_test_status("Multi-threaded Pipeline", ordered);
+}
+
+int main() {
+  test_single_threaded_fifo();
+  test_single_threaded_batch();
+  test_single_threaded_destruction();
+  test_single_threaded_throwing_batch();
+
+  // Multi-threaded tests
+  test_multi_threaded_pipeline();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,227 @@
+#include "../concurrent_thread_pool.h"
+#include "../concurrent_unordered_map.h"
+#include "../internal/work_stealing_deque.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_deque() {
+  std::cout << "\n--- Running Single-threaded Deque Test ---" << std::endl;
+  concurrent::internal::work_stealing_deque<int> deque(4);
+  int value = -1;
+  assert(!deque.pop(value) && !deque.steal(value));
+
+  // Grows past its initial capacity
+  for (int i = 0; i < 100; ++i)
+    deque.push(i);
+  assert(deque.size_approx() == 100);
+
+  // Owner takes the newest, thieves the oldest
+  assert(deque.pop(value) && value == 99);
+  assert(deque.steal(value) && value == 0);
+  assert(deque.steal(value) && value == 1);
+  assert(deque.pop(value) && value == 98);
+
+  int taken = 4;
+  while (deque.pop(value))
+    ++taken;
+  assert(taken == 100);
+  assert(deque.empty_approx());
+  assert(!deque.steal(value));
+
+  print_test_status("Single-threaded Deque", taken == 100);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_deque_stealing() {
+  std::cout << "\n--- Running Multi-threaded Deque Stealing Test ---"
+            << std::endl;
+  concurrent::internal::work_stealing_deque<int> deque(8);
+  const int count = 100000;
+  const int num_thieves = 3;
+  std::vector<std::atomic<int>> seen(count);
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < num_thieves; ++t)
+    thieves.emplace_back([&] {
+      int value;
+      while (!done.load()) {
+        if (deque.steal(value))
+          seen[value].fetch_add(1);
+      }
+      while (deque.steal(value))
+        seen[value].fetch_add(1);
+    });
+
+  // The owner pushes and pops in bursts, so the last element is often
+  // contended and the ring grows while thieves read it
+  int value;
+  for (int i = 0; i < count; ++i) {
+    deque.push(i);
+    if (i % 3 == 0 && deque.pop(value))
+      seen[value].fetch_add(1);
+  }
+  while (deque.pop(value))
+    seen[value].fetch_add(1);
+  done.store(true);
+  for (auto &t : thieves)
+    t.join();
+
+  // Every element was taken exactly once
+  bool once = true;
+  for (auto &s : seen)
+    once = once && s.load() == 1;
+  assert(once);
+
+  print_test_status("Multi-threaded Deque Stealing", once);
+}
+
+void test_multi_threaded_pool() {
+  std::cout << "\n--- Running Multi-threaded Pool Test ---" << std::endl;
+  concurrent::thread_pool pool(4);
+  assert(pool.size() == 4);
+
+  std::atomic<int> ran(0);
+  {
+    concurrent::thread_pool scoped(2);
+    for (int i = 0; i < 1000; ++i)
+      scoped.submit([&ran] { ran.fetch_add(1); });
+    // The destructor runs what is still queued
+  }
+  assert(ran.load() == 1000);
+
+  const size_t n = 100000;
+  std::vector<int> squares(n);
+  pool.parallel_for(0, n, [&](size_t i) {
+    squares[i] = static_cast<int>(i % 1000) * static_cast<int>(i % 1000);
+  });
+  bool filled = true;
+  for (size_t i = 0; i < n; ++i)
+    filled = filled && squares[i] == static_cast<int>((i % 1000) * (i % 1000));
+  assert(filled);
+
+  // Nested loops: workers waiting for an inner loop help run it
+  std::atomic<long> cells(0);
+  pool.parallel_for(
+      0, 16,
+      [&](size_t) {
+        pool.parallel_for(0, 1000, [&](size_t) { cells.fetch_add(1); }, 10);
+      },
+      1);
+  assert(cells.load() == 16000);
+
+  // The first exception comes back to the caller; the pool keeps working
+  bool threw = false;
+  try {
+    pool.parallel_for(0, 10000, [](size_t i) {
+      if (i == 5000)
+        throw std::runtime_error("boom");
+    });
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+  std::atomic<int> after(0);
+  pool.parallel_for(0, 100, [&](size_t) { after.fetch_add(1); });
+  assert(after.load() == 100);
+
+  bool passed = filled && cells.load() == 16000 && threw;
+  print_test_status("Multi-threaded Pool", passed);
+}
+
+template <typename Map> bool check_parallel_for_each(concurrent::thread_pool &pool) {
+  Map map;
+  const int n = 20000;
+  for (int i = 0; i < n; ++i)
+    map.insert(static_cast<typename Map::container_type::key_type>(i), i);
+
+  std::atomic<long> sum(0);
+  std::atomic<int> visited(0);
+  map.parallel_for_each(
+      [&](const auto &, const int &value) {
+        sum.fetch_add(value);
+        visited.fetch_add(1);
+      },
+      pool);
+  bool ok = visited.load() == n && sum.load() == long(n) * (n - 1) / 2;
+
+  map.parallel_update([](const auto &, int &value) { value *= 2; }, pool);
+  for (int i = 0; i < n; i += 97)
+    ok = ok &&
+         map.find(static_cast<typename Map::container_type::key_type>(i)) ==
+             2 * i;
+  return ok;
+}
+
+void test_multi_threaded_map_parallel_for_each() {
+  std::cout << "\n--- Running Multi-threaded Map parallel_for_each Test ---"
+            << std::endl;
+  concurrent::thread_pool pool(3);
+  // Flat backend split by index, node-based backend split by bucket
+  bool flat =
+      check_parallel_for_each<concurrent::flat_unordered_map<int, int>>(pool);
+  bool nodes =
+      check_parallel_for_each<concurrent::unordered_map<int, int>>(pool);
+  assert(flat && nodes);
+
+  // Default pool
+  concurrent::unordered_map<int, int> map;
+  map.insert(1, 1);
+  int seen = 0;
+  map.parallel_for_each([&](int, int value) { seen += value; });
+  assert(seen == 1);
+
+  // A caller waiting for its loop under the map lock runs only that loop's
+  // pieces, never an unrelated task that needs the same lock
+  concurrent::thread_pool single(1);
+  concurrent::unordered_map<int, int> locked;
+  for (int i = 0; i < 1000; ++i)
+    locked.insert(i, i);
+  std::atomic<bool> started(false);
+  std::atomic<int> found(-1);
+  single.submit([&] {
+    while (!started.load())
+      std::this_thread::yield();
+  });
+  single.submit([&] { found.store(*locked.find(7)); });
+  locked.parallel_update(
+      [&](int, int &value) {
+        started.store(true);
+        value += 1;
+      },
+      single);
+  while (found.load() < 0)
+    std::this_thread::yield();
+  bool unrelated = found.load() == 8;
+  assert(unrelated);
+
+  print_test_status("Multi-threaded Map parallel_for_each",
+                    flat && nodes && unrelated);
+}
+
+int main() {
+  test_single_threaded_deque();
+
+  // Multi-threaded tests
+  test_multi_threaded_deque_stealing();
+  test_multi_threaded_pool();
+  test_multi_threaded_map_parallel_for_each();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
@@ -1,3 +1,4 @@
+#include "../concurrent_counting_allocator.h"
 #include "../concurrent_unordered_map.h"
 
 #include <algorithm>
@@ -5,6 +6,8 @@
 #include <cassert>
 #include <iostream>
 #include <map>
+#include <memory_resource>
+#include <new>
 #include <numeric>
 #include <string>
 #include <thread>
@@ -227,9 +230,292 @@ void test_single_threaded_execute_ops() {
   assert(sum_of_values == 90);
   assert(map.empty()); // Verify clear happened
 
+  // The node-based table keeps references valid across inserts
+  concurrent::unordered_map<int, int> stable;
+  int kept = stable.execute_exclusive([](auto &internal_map) {
+    int &first = internal_map[1];
+    for (int i = 2; i < 1000; ++i)
+      internal_map[i] = i;
+    first = 7;
+    return internal_map.at(1);
+  });
+  assert(kept == 7);
+
+  // and takes values that cannot be moved
+  concurrent::unordered_map<int, std::atomic<int>> counters;
+  counters.execute_exclusive([](auto &internal_map) {
+    internal_map[1]++;
+    internal_map[1]++;
+  });
+  int count = counters.execute_shared(
+      [](const auto &internal_map) { return internal_map.at(1).load(); });
+  assert(count == 2);
+
   print_test_status("Single-threaded Execute Ops", map.empty());
 }
 
+void test_single_threaded_range_insert() {
+  std::cout << "\n--- Running Single-threaded Range Insert Test ---"
+            << std::endl;
+  concurrent::unordered_map<int, std::string> map;
+  map.reserve(100);
+
+  std::vector<std::pair<int, std::string>> items = {
+      {1, "one"}, {2, "two"}, {3, "three"}};
+  map.insert(items.begin(), items.end());
+  assert(map.size() == 3);
+  assert(map.find(2).value() == "two");
+
+  // Existing keys are kept, like std::unordered_map::insert
+  std::vector<std::pair<int, std::string>> more = {{3, "THREE"}, {4, "four"}};
+  map.insert(more.begin(), more.end());
+  assert(map.size() == 4);
+  assert(map.find(3).value() == "three");
+
+  map.rehash(1000);
+  size_t buckets = map.execute_shared(
+      [](const auto &internal_map) { return internal_map.bucket_count(); });
+  assert(buckets >= 1000);
+  assert(map.find(4).value() == "four");
+
+  print_test_status("Single-threaded Range Insert", map.size() == 4);
+}
+
+void test_single_threaded_pmr() {
+  std::cout << "\n--- Running Single-threaded PMR Test ---" << std::endl;
+  std::pmr::unsynchronized_pool_resource pool;
+  concurrent::pmr::unordered_map<int, std::pmr::string> map(&pool);
+
+  map.insert(1, std::pmr::string("one"));
+  map.emplace(2, "two");
+  assert(map.size() == 2);
+  assert(map.find(1).value() == "one");
+
+  bool uses_pool = map.execute_shared([&](const auto &internal_map) {
+    return internal_map.get_allocator().resource() == &pool;
+  });
+  assert(uses_pool);
+
+  print_test_status("Single-threaded PMR", uses_pool);
+}
+
+void test_single_threaded_bulk_map() {
+  std::cout << "\n--- Running Single-threaded Bulk Map Test ---" << std::endl;
+  const int num_items = 10000;
+
+  // Trivially destructible: destruction only releases the buffer
+  concurrent::pmr::bulk_unordered_map<int, int> ints(1 << 20);
+  ints->reserve(num_items);
+  for (int i = 0; i < num_items; ++i)
+    ints->insert(i, i * 2);
+  assert(ints->size() == num_items);
+  assert(ints->find(1234).value() == 2468);
+
+  // Non-trivial values still get their destructors run
+  concurrent::pmr::bulk_unordered_map<int, std::string> strings;
+  for (int i = 0; i < 100; ++i)
+    strings.map().insert(i, std::string(64, 'x'));
+  assert(strings->size() == 100);
+  assert(strings->find(7).value().size() == 64);
+
+  // Trivial elements, but a hash that owns a resource: the map's members
+  // are still destroyed
+  static int live_hashes = 0;
+  struct counted_hash : std::hash<int> {
+    counted_hash() { ++live_hashes; }
+    counted_hash(const counted_hash &) { ++live_hashes; }
+    ~counted_hash() { --live_hashes; }
+  };
+  {
+    concurrent::pmr::bulk_unordered_map<int, int, counted_hash> counted;
+    for (int i = 0; i < 100; ++i)
+      counted->insert(i, i);
+    assert(live_hashes > 0);
+  }
+  assert(live_hashes == 0);
+
+  print_test_status("Single-threaded Bulk Map",
+                    ints->size() == num_items && live_hashes == 0);
+}
+
+void test_single_threaded_memory_usage() {
+  std::cout << "\n--- Running Single-threaded Memory Usage Test ---"
+            << std::endl;
+  using alloc = concurrent::counting_allocator<std::pair<const int, std::string>>;
+  concurrent::allocation_counter counter;
+  concurrent::unordered_map<int, std::string, std::hash<int>,
+                            std::equal_to<int>, alloc>
+      map{alloc(&counter)};
+
+  auto empty_usage = map.memory_usage();
+  for (int i = 0; i < 1000; ++i)
+    map.insert(i, std::string(100, 'x'));
+
+  auto usage = map.memory_usage();
+  assert(usage.node_bytes > empty_usage.node_bytes);
+  assert(usage.bucket_bytes >= 1000 * sizeof(void *) / 2);
+  assert(usage.value_bytes == 0);
+
+  // The estimate is close to what the allocator actually handed out
+  size_t counted = counter.bytes();
+  assert(counted > 0);
+  assert(usage.bucket_bytes + usage.node_bytes >= counted / 2);
+  assert(usage.bucket_bytes + usage.node_bytes <= counted * 2);
+
+  auto with_values = map.memory_usage(
+      [](const int &, const std::string &value) { return value.capacity(); });
+  assert(with_values.value_bytes >= 1000 * 100);
+  assert(with_values.total() == usage.total() + with_values.value_bytes);
+
+  map.clear();
+  map.rehash(0);
+  assert(counter.peak() >= counted);
+
+  print_test_status("Single-threaded Memory Usage", counted > 0);
+}
+
+void test_single_threaded_allocation_budget() {
+  std::cout << "\n--- Running Single-threaded Allocation Budget Test ---"
+            << std::endl;
+  using alloc = concurrent::counting_allocator<std::pair<const int, int>>;
+  concurrent::allocation_counter tenant(4096);
+  concurrent::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                            alloc>
+      map{alloc(&tenant)};
+
+  bool rejected = false;
+  int inserted = 0;
+  try {
+    for (int i = 0; i < 100000; ++i) {
+      map.insert(i, i);
+      ++inserted;
+    }
+  } catch (const std::bad_alloc &) {
+    rejected = true;
+  }
+  assert(rejected);
+  assert(tenant.bytes() <= tenant.limit());
+  assert(map.size() == static_cast<size_t>(inserted));
+
+  map.clear();
+  map.rehash(0);
+  size_t after_clear = tenant.bytes();
+  assert(after_clear < 4096);
+
+  print_test_status("Single-threaded Allocation Budget", rejected);
+}
+
+struct constant_hash {
+  size_t operator()(int) const { return 42; }
+};
+
+void test_single_threaded_diagnostics() {
+  std::cout << "\n--- Running Single-threaded Diagnostics Test ---"
+            << std::endl;
+  const int num_items = 2000;
+
+  concurrent::unordered_map<int, int> good;
+  concurrent::unordered_map<int, int, constant_hash> bad;
+  for (int i = 0; i < num_items; ++i) {
+    good.insert(i, i);
+    bad.insert(i, i);
+  }
+
+  concurrent::hash_diagnostics g = good.diagnostics(0);
+  assert(g.size == num_items);
+  assert(g.sampled_buckets == g.bucket_count);
+  assert(g.load_factor <= g.max_load_factor);
+  assert(g.max_chain_length <= 8);
+  assert(g.shard_imbalance < 2.0);
+
+  // Every key in one bucket and one shard
+  concurrent::hash_diagnostics b = bad.diagnostics(0);
+  assert(b.max_chain_length == num_items);
+  assert(b.avg_chain_length == num_items);
+  assert(b.empty_bucket_fraction > b.expected_empty_bucket_fraction);
+  assert(b.shard_imbalance == 16.0);
+
+  // Sampling bounds the work on large tables
+  concurrent::hash_diagnostics sampled = good.diagnostics(64);
+  assert(sampled.sampled_buckets <= 2 * 64);
+  assert(sampled.sampled_buckets > 0);
+
+  print_test_status("Single-threaded Diagnostics",
+                    b.max_chain_length == num_items);
+}
+
+// Collides everything until the map reseeds it, like a hash whose seed has
+// been recovered by an attacker
+struct leaked_seed_hash {
+  using is_seeded = void;
+  uint64_t seed = 0;
+
+  leaked_seed_hash() = default;
+  explicit leaked_seed_hash(uint64_t s) : seed(s) {}
+
+  size_t operator()(int key) const {
+    return seed == 0 ? 42 : concurrent::seeded_hash<int>(seed)(key);
+  }
+};
+
+// Seeded, but every key collides whatever the seed, like seeded_hash over a
+// std::hash that collides. Counts its calls, which every reseed pays for.
+struct seed_proof_hash {
+  using is_seeded = void;
+  static inline size_t calls = 0;
+
+  seed_proof_hash() = default;
+  explicit seed_proof_hash(uint64_t) {}
+
+  size_t operator()(int) const {
+    ++calls;
+    return 42;
+  }
+};
+
+void test_single_threaded_flood_guard() {
+  std::cout << "\n--- Running Single-threaded Flood Guard Test ---"
+            << std::endl;
+  const int num_items = 2000;
+
+  concurrent::unordered_map<int, int, leaked_seed_hash> map;
+  for (int i = 0; i < num_items / 2; ++i)
+    map.insert(i, i);
+  std::vector<std::pair<const int, int>> rest;
+  for (int i = num_items / 2; i < num_items; ++i)
+    rest.emplace_back(i, i);
+  map.insert(rest.begin(), rest.end());
+
+  // The long chain triggered a rebuild with a fresh seed
+  concurrent::hash_diagnostics d = map.diagnostics(0);
+  assert(d.size == num_items);
+  assert(d.max_chain_length <= concurrent::internal::flood_chain_threshold);
+  for (int i = 0; i < num_items; ++i)
+    assert(map.find(i) == i);
+
+  // Hashers that cannot be reseeded are left alone
+  concurrent::unordered_map<int, int, constant_hash> plain;
+  for (int i = 0; i < 100; ++i)
+    plain.insert(i, i);
+  assert(plain.diagnostics(0).max_chain_length == 100);
+
+  // Collisions that no seed breaks: the guard stops after one reseed
+  // instead of rebuilding the table on every insert
+  seed_proof_hash::calls = 0;
+  concurrent::unordered_map<int, int, seed_proof_hash> proof;
+  for (int i = 0; i < num_items; ++i)
+    proof.insert(i, i);
+  for (int i = 0; i < num_items; i += 97)
+    assert(proof.find(i) == i);
+  bool bounded = seed_proof_hash::calls < 4 * num_items;
+  assert(bounded);
+
+  print_test_status("Single-threaded Flood Guard",
+                    d.max_chain_length <=
+                            concurrent::internal::flood_chain_threshold &&
+                        bounded);
+}
+
 // --- Multi-threaded Tests ---
 
 void insert_worker(concurrent::unordered_map<int, int> &map, int start,
@@ -453,6 +739,13 @@ int main() {
   test_single_threaded_emplace();
   test_single_threaded_snapshot();
   test_single_threaded_execute_ops();
+  test_single_threaded_range_insert();
+  test_single_threaded_pmr();
+  test_single_threaded_bulk_map();
+  test_single_threaded_memory_usage();
+  test_single_threaded_allocation_budget();
+  test_single_threaded_diagnostics();
+  test_single_threaded_flood_guard();
 
   // Multi-threaded tests
   test_multi_threaded_insert();
@@ -0,0 +1,130 @@
+#include "../concurrent_unordered_set.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::unordered_set<std::string> set;
+  // Node-based for every key type, like the default unordered_map
+  static_assert(std::is_same_v<
+                concurrent::unordered_set<int>::container_type,
+                std::unordered_set<int, concurrent::hash<int>>>);
+
+  assert(set.empty());
+  assert(set.insert("a"));
+  assert(!set.insert("a"));
+  assert(set.insert(std::string("b")));
+  assert(set.emplace(3, 'c'));
+  assert(set.size() == 3);
+  assert(set.contains("ccc"));
+  assert(set.count("b") == 1);
+  assert(!set.contains("d"));
+
+  assert(set.insert_if_absent("d"));
+  assert(!set.insert_if_absent("d"));
+
+  auto snap = set.snapshot();
+  std::sort(snap.begin(), snap.end());
+  assert((snap == std::vector<std::string>{"a", "b", "ccc", "d"}));
+
+  assert(set.erase("a") == 1);
+  assert(set.erase("a") == 0);
+  set.clear();
+  assert(set.empty());
+
+  print_test_status("Single-threaded Basic Ops", set.empty());
+}
+
+void test_single_threaded_batch() {
+  std::cout << "\n--- Running Single-threaded Batch Test ---" << std::endl;
+  concurrent::unordered_set<int> set;
+  set.reserve(100);
+
+  std::vector<int> first = {1, 2, 3, 2};
+  assert(set.insert(first.begin(), first.end()) == 3);
+
+  // Only keys new to the set are reported, once each, in input order
+  std::vector<int> batch = {3, 4, 5, 4, 1, 6};
+  std::vector<int> fresh;
+  set.insert_if_absent(batch.begin(), batch.end(), std::back_inserter(fresh));
+  assert((fresh == std::vector<int>{4, 5, 6}));
+  assert(set.size() == 6);
+
+  print_test_status("Single-threaded Batch", fresh.size() == 3);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_dedup() {
+  std::cout << "\n--- Running Multi-threaded De-duplication Test ---"
+            << std::endl;
+  concurrent::unordered_set<int> set;
+  const int num_threads = 8;
+  const int num_events = 20000;
+  const int num_keys = 5000;
+
+  // Every thread sees the same stream of events; each key must be reported
+  // as new by exactly one thread
+  std::vector<std::vector<int>> fresh(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::vector<int> batch;
+      for (int i = 0; i < num_events; ++i) {
+        int key = (i * 7919 + t) % num_keys;
+        if (t % 2) {
+          if (set.insert_if_absent(key))
+            fresh[t].push_back(key);
+          continue;
+        }
+        batch.push_back(key);
+        if (batch.size() == 64) {
+          set.insert_if_absent(batch.begin(), batch.end(),
+                               std::back_inserter(fresh[t]));
+          batch.clear();
+        }
+      }
+      set.insert_if_absent(batch.begin(), batch.end(),
+                           std::back_inserter(fresh[t]));
+    });
+  }
+  for (auto &th : threads)
+    th.join();
+
+  std::vector<int> all;
+  for (const auto &f : fresh)
+    all.insert(all.end(), f.begin(), f.end());
+  std::sort(all.begin(), all.end());
+  assert(std::adjacent_find(all.begin(), all.end()) == all.end());
+  assert(all.size() == set.size());
+  assert(set.size() == static_cast<size_t>(num_keys));
+
+  print_test_status("Multi-threaded De-duplication", all.size() == set.size());
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_batch();
+
+  // Multi-threaded tests
+  test_multi_threaded_dedup();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
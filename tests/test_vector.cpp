@@ -0,0 +1,198 @@
+#include "../concurrent_vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to print test results
+void print_test_status(const std::string &test_name, bool passed) {
+  std::cout << test_name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+}
+
+// --- Single-threaded Tests ---
+
+void test_single_threaded_basic_ops() {
+  std::cout << "\n--- Running Single-threaded Basic Ops Test ---" << std::endl;
+  concurrent::vector<std::string> vec;
+  assert(vec.empty() && vec.capacity() == 0);
+
+  assert(vec.push_back("a") == 0);
+  std::string b = "b";
+  assert(vec.push_back(b) == 1);
+  assert(vec.emplace_back(3, 'c') == 2);
+  assert(vec.size() == 3 && vec[2] == "ccc" && vec.at(1) == "b");
+
+  // References survive growth: segments are never moved
+  const std::string *first = &vec[0];
+  for (int i = 0; i < 1000; ++i)
+    vec.push_back(std::to_string(i));
+  assert(first == &vec[0] && *first == "a");
+  assert(vec[3 + 999] == "999");
+
+  assert(vec.grow_by(5, "x") == 1003);
+  std::vector<std::string> more = {"y", "z"};
+  assert(vec.grow_by(more.begin(), more.end()) == 1008);
+  assert(vec.size() == 1010 && vec[1007] == "x" && vec[1009] == "z");
+  assert(vec.capacity() >= vec.size());
+
+  bool threw = false;
+  try {
+    vec.at(1010);
+  } catch (const std::out_of_range &) {
+    threw = true;
+  }
+  assert(threw);
+
+  auto all = vec.snapshot();
+  size_t visited = 0;
+  vec.for_each([&](size_t i, std::string &value) {
+    assert(value == all[i]);
+    ++visited;
+  });
+  bool passed = threw && all.size() == 1010 && visited == 1010;
+  assert(passed);
+
+  print_test_status("Single-threaded Basic Ops", passed);
+}
+
+struct fragile {
+  std::shared_ptr<int> tracker;
+  fragile(std::shared_ptr<int> t, bool fail) : tracker(std::move(t)) {
+    if (fail)
+      throw std::runtime_error("construction failed");
+  }
+};
+
+void test_single_threaded_lifetime() {
+  std::cout << "\n--- Running Single-threaded Lifetime Test ---" << std::endl;
+  auto tracker = std::make_shared<int>(0);
+  {
+    concurrent::vector<fragile> vec;
+    vec.reserve(100);
+    assert(vec.capacity() >= 100 && vec.empty());
+    vec.emplace_back(tracker, false);
+    bool threw = false;
+    try {
+      vec.emplace_back(tracker, true);
+    } catch (const std::runtime_error &) {
+      threw = true;
+    }
+    vec.emplace_back(tracker, false);
+    assert(threw);
+
+    // The failed element keeps its index but is never visited or destroyed
+    assert(vec.size() == 3 && vec.snapshot().size() == 2);
+    threw = false;
+    try {
+      vec.at(1);
+    } catch (const std::out_of_range &) {
+      threw = true;
+    }
+    assert(threw);
+    assert(tracker.use_count() == 3); // The two constructed elements
+  }
+  bool released = tracker.use_count() == 1;
+  assert(released);
+
+  print_test_status("Single-threaded Lifetime", released);
+}
+
+// --- Multi-threaded Tests ---
+
+void test_multi_threaded_push_back() {
+  std::cout << "\n--- Running Multi-threaded Push Back Test ---" << std::endl;
+  concurrent::vector<long> vec;
+  const int num_threads = 4;
+  const long per_thread = 50000;
+  std::atomic<bool> done(false);
+  std::atomic<bool> consistent(true);
+
+  // A reader scans while the vector grows and must only ever see fully
+  // written values
+  std::thread reader([&] {
+    while (!done.load())
+      vec.for_each([&](size_t, long value) {
+        if (value < 0 || value >= num_threads * per_thread)
+          consistent.store(false);
+      });
+  });
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      for (long i = 0; i < per_thread; ++i) {
+        long value = t * per_thread + i;
+        size_t index =
+            i % 10 == 0 ? vec.grow_by(1, value) : vec.push_back(value);
+        if (vec[index] != value)
+          consistent.store(false);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+  done.store(true);
+  reader.join();
+
+  // Every value is there exactly once
+  auto all = vec.snapshot();
+  std::sort(all.begin(), all.end());
+  bool complete = all.size() == static_cast<size_t>(num_threads * per_thread);
+  for (size_t i = 0; complete && i < all.size(); ++i)
+    complete = all[i] == static_cast<long>(i);
+  assert(consistent.load());
+  assert(complete);
+
+  print_test_status("Multi-threaded Push Back", consistent.load() && complete);
+}
+
+void test_multi_threaded_grow_by() {
+  std::cout << "\n--- Running Multi-threaded Grow By Test ---" << std::endl;
+  concurrent::vector<int> vec;
+  const int num_threads = 4;
+  const int blocks = 2000;
+
+  // Blocks of different sizes from different threads stay contiguous
+  std::vector<std::vector<std::pair<size_t, size_t>>> claimed(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < blocks; ++i) {
+        size_t n = static_cast<size_t>(i % 37 + 1);
+        claimed[t].emplace_back(vec.grow_by(n, t), n);
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+
+  bool contiguous = true;
+  size_t total = 0;
+  for (int t = 0; t < num_threads; ++t)
+    for (auto [first, n] : claimed[t]) {
+      total += n;
+      for (size_t i = first; i < first + n; ++i)
+        contiguous = contiguous && vec[i] == t;
+    }
+  contiguous = contiguous && total == vec.size();
+  assert(contiguous);
+
+  print_test_status("Multi-threaded Grow By", contiguous);
+}
+
+int main() {
+  test_single_threaded_basic_ops();
+  test_single_threaded_lifetime();
+
+  // Multi-threaded tests
+  test_multi_threaded_push_back();
+  test_multi_threaded_grow_by();
+
+  std::cout << "\nAll tests finished." << std::endl;
+
+  return 0;
+}
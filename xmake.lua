@@ -1,8 +1,39 @@
 add_rules("mode.debug", "mode.release")
 
+option("lock_stats")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Record lock contention statistics in container_base")
+    add_defines("CONCURRENT_STL_LOCK_STATS")
+option_end()
+
+option("op_stats")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Record per-operation latency statistics in containers")
+    add_defines("CONCURRENT_STL_OP_STATS")
+option_end()
+
 target("concurrent_stl")
     set_kind("headeronly")
     add_headerfiles("concurrent_unordered_map.h")
+    add_headerfiles("concurrent_unordered_set.h")
+    add_headerfiles("concurrent_pool_allocator.h")
+    add_headerfiles("concurrent_counting_allocator.h")
+    add_headerfiles("concurrent_hash.h")
+    add_headerfiles("concurrent_counter_map.h")
+    add_headerfiles("concurrent_mpmc_queue.h")
+    add_headerfiles("concurrent_mpsc_queue.h")
+    add_headerfiles("concurrent_spsc_queue.h")
+    add_headerfiles("concurrent_thread_pool.h")
+    add_headerfiles("concurrent_map.h")
+    add_headerfiles("concurrent_btree_map.h")
+    add_headerfiles("concurrent_vector.h")
+    add_headerfiles("concurrent_priority_queue.h")
+    add_headerfiles("concurrent_lru_cache.h")
+    add_headerfiles("concurrent_clock_cache.h")
+    add_headerfiles("internal/*.h", {prefixdir = "internal"})
+    add_options("lock_stats", "op_stats")
 
 for _, file in ipairs(os.files("tests/test_*.cpp")) do
      local name = path.basename(file)
@@ -10,6 +41,16 @@ for _, file in ipairs(os.files("tests/test_*.cpp")) do
          set_kind("binary")
          set_default(false)
          add_files("tests/" .. name .. ".cpp")
+         add_options("lock_stats", "op_stats")
          add_tests("default")
 
-end
\ No newline at end of file
+end
+
+for _, file in ipairs(os.files("benchmarks/bench_*.cpp")) do
+     local name = path.basename(file)
+     target(name)
+         set_kind("binary")
+         set_default(false)
+         add_files("benchmarks/" .. name .. ".cpp")
+         add_options("lock_stats", "op_stats")
+end